@@ -0,0 +1,600 @@
+#pragma once
+
+#include <QMetaType>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+
+
+/**
+ * Statistics accumulating a stream of samples in O(1) per sample, used as statistic types
+ * instead of hand-written running sums, e.g.
+ *      stats = api::var(this,
+ *          api::var<api::accumulator::Mean>("Waiting time", "Mean waiting time"),
+ *          api::var<api::accumulator::Quantile>("Median", "Median waiting time", api::accumulator::Quantile{0.5}),
+ *          api::var<api::accumulator::Histogram>("Waiting times", "Distribution of waiting times",
+ *                                                api::accumulator::Histogram{0.0, 60.0, 30}));
+ *      ...
+ *      waitingTime = stats.handle<api::accumulator::Mean>("Waiting time");   // in setup()
+ *      waitingTime->add(time);                                               // in run()
+ *      api::merge::accumulate<api::accumulator::Mean>(total, partial, "Waiting time");  // in merge()
+ * Accumulators keep only raw state (counts, sums, markers) copied into snapshots like plain values,
+ * derived values (variance, standard error, quantile estimate) are computed when a snapshot is decoded.
+ * The application shows them as value ± standard error.
+ */
+namespace api::accumulator
+{
+
+/**
+ * @brief The Estimate struct
+ * Value of an accumulator with its standard error, the error is NaN if unknown
+ */
+struct Estimate
+{
+    double value = 0.0;
+    double error = std::numeric_limits<double>::quiet_NaN();
+
+    QString toString() const
+    {
+        if (std::isfinite(error))
+            return QStringLiteral("%1 ± %2").arg(value).arg(error);
+        return QString::number(value);
+    }
+};
+
+
+/**
+ * @brief The Mean class
+ * Mean and variance of samples (Welford's algorithm), merged with the formula of Chan et al.
+ */
+class Mean
+{
+public:
+    void add(double sample)
+    {
+        ++m_count;
+        const auto delta = sample - m_mean;
+        m_mean += delta / static_cast<double>(m_count);
+        m_squares += delta * (sample - m_mean);
+    }
+
+    void merge(const Mean& other)
+    {
+        if (other.m_count == 0)
+            return;
+        const auto count = m_count + other.m_count;
+        const auto delta = other.m_mean - m_mean;
+        const auto weight = static_cast<double>(other.m_count) / static_cast<double>(count);
+        m_mean += delta * weight;
+        m_squares += other.m_squares + delta * delta * static_cast<double>(m_count) * weight;
+        m_count = count;
+    }
+
+    qint64 count() const { return m_count; }
+    double value() const { return m_mean; }
+
+    double variance() const
+    {
+        if (m_count < 2)
+            return std::numeric_limits<double>::quiet_NaN();
+        return m_squares / static_cast<double>(m_count - 1);
+    }
+
+    double standardDeviation() const { return std::sqrt(variance()); }
+    double error() const { return std::sqrt(variance() / static_cast<double>(m_count)); }
+    Estimate estimate() const { return {value(), error()}; }
+
+private:
+    qint64 m_count = 0;
+    double m_mean = 0.0;
+    double m_squares = 0.0;  // sum of squared deviations from the mean
+};
+
+
+/**
+ * @brief The Extremes class
+ * Smallest and greatest sample
+ */
+class Extremes
+{
+public:
+    void add(double sample)
+    {
+        ++m_count;
+        m_minimum = std::min(m_minimum, sample);
+        m_maximum = std::max(m_maximum, sample);
+    }
+
+    void merge(const Extremes& other)
+    {
+        m_count += other.m_count;
+        m_minimum = std::min(m_minimum, other.m_minimum);
+        m_maximum = std::max(m_maximum, other.m_maximum);
+    }
+
+    qint64 count() const { return m_count; }
+    double minimum() const { return m_minimum; }
+    double maximum() const { return m_maximum; }
+
+    QString toString() const
+    {
+        if (m_count == 0)
+            return QStringLiteral("-");
+        return QStringLiteral("%1 – %2").arg(m_minimum).arg(m_maximum);
+    }
+
+private:
+    qint64 m_count = 0;
+    double m_minimum = std::numeric_limits<double>::infinity();
+    double m_maximum = -std::numeric_limits<double>::infinity();
+};
+
+
+/**
+ * @brief The Quantile class
+ * Quantile of samples estimated with the P² algorithm (Jain, Chlamtac) from five markers,
+ * exact for less than five samples. Merging interpolates the ranks of markers of both parts,
+ * so the merged estimate is approximate.
+ */
+class Quantile
+{
+    static constexpr int markers = 5;
+
+public:
+    Quantile() = default;
+    explicit Quantile(double probability)
+        : m_probability{std::clamp(probability, 0.0, 1.0)}
+    {}
+
+    void add(double sample)
+    {
+        if (m_count < markers)
+        {
+            // the first samples are kept sorted, they become the initial markers
+            auto* last = m_heights.data() + m_count;
+            auto* position = std::upper_bound(m_heights.data(), last, sample);
+            std::copy_backward(position, last, last + 1);
+            *position = sample;
+            if (++m_count == markers)
+                initializeMarkers();
+            return;
+        }
+
+        // cell of the sample, extreme markers follow new extremes
+        int cell = 0;
+        if (sample < m_heights[0])
+        {
+            m_heights[0] = sample;
+        }
+        else if (sample >= m_heights[markers - 1])
+        {
+            m_heights[markers - 1] = sample;
+            cell = markers - 2;
+        }
+        else
+        {
+            while (sample >= m_heights[cell + 1])
+                ++cell;
+        }
+
+        ++m_count;
+        const auto increments = this->increments();
+        for (int i = 0; i < markers; ++i)
+        {
+            if (i > cell)
+                m_positions[i] += 1.0;
+            m_desired[i] += increments[i];
+        }
+        adjustMarkers();
+    }
+
+    void merge(const Quantile& other)
+    {
+        if (other.m_count < markers)
+        {
+            for (int i = 0; i < other.m_count; ++i)
+                add(other.m_heights[i]);
+            return;
+        }
+        if (m_count < markers)
+        {
+            auto merged = other;
+            for (int i = 0; i < m_count; ++i)
+                merged.add(m_heights[i]);
+            *this = merged;
+            return;
+        }
+
+        // heights are read from the sum of rank functions of both parts at the new marker positions
+        std::array<double, 2 * markers> heights;
+        std::copy(m_heights.begin(), m_heights.end(), heights.begin());
+        std::copy(other.m_heights.begin(), other.m_heights.end(), heights.begin() + markers);
+        std::sort(heights.begin(), heights.end());
+        const auto part = *this;
+        const auto rank = [&part, &other](double height) { return part.rank(height) + other.rank(height); };
+        const auto heightOfRank = [&heights, &rank](double target) {
+            auto previous = heights.front();
+            auto previousRank = rank(previous);
+            if (target <= previousRank)
+                return previous;
+            for (const auto height : heights)
+            {
+                const auto heightRank = rank(height);
+                if (heightRank >= target)
+                    return previous + (height - previous) * (target - previousRank) / (heightRank - previousRank);
+                previous = height;
+                previousRank = heightRank;
+            }
+            return heights.back();
+        };
+
+        m_count += other.m_count;
+        const auto count = static_cast<double>(m_count);
+        initializeDesired(count);
+        m_positions[0] = 1.0;
+        m_positions[markers - 1] = count;
+        for (int i = 1; i < markers - 1; ++i)
+            m_positions[i] = std::clamp(std::round(m_desired[i]), m_positions[i - 1] + 1.0, count - (markers - 1 - i));
+        const auto minimum = heights.front();
+        const auto maximum = heights.back();
+        for (int i = 1; i < markers - 1; ++i)
+            m_heights[i] = heightOfRank(m_positions[i]);
+        m_heights[0] = minimum;
+        m_heights[markers - 1] = maximum;
+    }
+
+    qint64 count() const { return m_count; }
+    double probability() const { return m_probability; }
+
+    double value() const
+    {
+        if (m_count == 0)
+            return 0.0;
+        if (m_count < markers)
+        {
+            // linear interpolation between the sorted samples
+            const auto position = m_probability * static_cast<double>(m_count - 1);
+            const auto lower = static_cast<int>(position);
+            const auto upper = std::min(lower + 1, static_cast<int>(m_count - 1));
+            return m_heights[lower] + (m_heights[upper] - m_heights[lower]) * (position - lower);
+        }
+        return m_heights[2];
+    }
+
+    Estimate estimate() const { return {value()}; }
+
+private:
+    std::array<double, markers> increments() const
+    {
+        return {0.0, m_probability / 2.0, m_probability, (1.0 + m_probability) / 2.0, 1.0};
+    }
+
+    void initializeMarkers()
+    {
+        m_positions = {1.0, 2.0, 3.0, 4.0, 5.0};
+        initializeDesired(markers);
+    }
+
+    void initializeDesired(double count)
+    {
+        const auto increments = this->increments();
+        for (int i = 0; i < markers; ++i)
+            m_desired[i] = 1.0 + (count - 1.0) * increments[i];
+    }
+
+    void adjustMarkers()
+    {
+        for (int i = 1; i < markers - 1; ++i)
+        {
+            const auto offset = m_desired[i] - m_positions[i];
+            if ((offset >= 1.0 && m_positions[i + 1] - m_positions[i] > 1.0) ||
+                (offset <= -1.0 && m_positions[i - 1] - m_positions[i] < -1.0))
+            {
+                const auto step = offset > 0.0 ? 1 : -1;
+                const auto parabolic = this->parabolic(i, step);
+                if (m_heights[i - 1] < parabolic && parabolic < m_heights[i + 1])
+                    m_heights[i] = parabolic;
+                else
+                    m_heights[i] += step * (m_heights[i + step] - m_heights[i]) / (m_positions[i + step] - m_positions[i]);
+                m_positions[i] += step;
+            }
+        }
+    }
+
+    double parabolic(int i, int step) const
+    {
+        const auto d = static_cast<double>(step);
+        return m_heights[i] + d / (m_positions[i + 1] - m_positions[i - 1]) *
+                                  ((m_positions[i] - m_positions[i - 1] + d) * (m_heights[i + 1] - m_heights[i]) / (m_positions[i + 1] - m_positions[i]) +
+                                   (m_positions[i + 1] - m_positions[i] - d) * (m_heights[i] - m_heights[i - 1]) / (m_positions[i] - m_positions[i - 1]));
+    }
+
+    double rank(double height) const
+    {
+        // number of samples not greater than the height, interpolated between markers
+        if (height < m_heights[0])
+            return 0.0;
+        if (height >= m_heights[markers - 1])
+            return m_positions[markers - 1];
+        int cell = 0;
+        while (height >= m_heights[cell + 1])
+            ++cell;
+        return m_positions[cell] + (m_positions[cell + 1] - m_positions[cell]) * (height - m_heights[cell]) / (m_heights[cell + 1] - m_heights[cell]);
+    }
+
+private:
+    double m_probability = 0.5;
+    qint64 m_count = 0;
+    std::array<double, markers> m_heights{};  // the first samples until there are five of them
+    std::array<double, markers> m_positions{};
+    std::array<double, markers> m_desired{};
+};
+
+
+/**
+ * @brief The BatchMeans class
+ * Mean of a correlated sequence of samples (e.g. waiting times of consecutive clients)
+ * with the standard error estimated from means of consecutive batches of samples.
+ * Batches should be much longer than the correlation of samples.
+ */
+class BatchMeans
+{
+public:
+    BatchMeans() = default;
+    explicit BatchMeans(qint64 batchSize)
+        : m_batchSize{std::max<qint64>(batchSize, 1)}
+    {}
+
+    void add(double sample)
+    {
+        ++m_count;
+        m_sum += sample;
+        m_batchSum += sample;
+        if (++m_batchCount == m_batchSize)
+            closeBatch();
+    }
+
+    void merge(const BatchMeans& other)
+    {
+        // unfinished batches of both parts are joined into one
+        m_count += other.m_count;
+        m_sum += other.m_sum;
+        m_batches.merge(other.m_batches);
+        m_batchSum += other.m_batchSum;
+        m_batchCount += other.m_batchCount;
+        if (m_batchCount >= m_batchSize)
+            closeBatch();
+    }
+
+    qint64 count() const { return m_count; }
+    qint64 batches() const { return m_batches.count(); }
+    double value() const { return m_count > 0 ? m_sum / static_cast<double>(m_count) : 0.0; }
+    double error() const { return m_batches.error(); }
+    Estimate estimate() const { return {value(), error()}; }
+
+private:
+    void closeBatch()
+    {
+        m_batches.add(m_batchSum / static_cast<double>(m_batchCount));
+        m_batchSum = 0.0;
+        m_batchCount = 0;
+    }
+
+private:
+    qint64 m_batchSize = 1000;
+    qint64 m_count = 0;
+    double m_sum = 0.0;
+    double m_batchSum = 0.0;
+    qint64 m_batchCount = 0;
+    Mean m_batches;
+};
+
+
+/**
+ * @brief The Histogram class
+ * Counts of samples in bins of a range, drawn as a bar chart by the application.
+ * Bins are equal in the linear scale or in the logarithm of samples (logarithmic scale).
+ * The adaptive scale starts with the given range and doubles the width of bins
+ * (joining pairs of them) whenever a sample exceeds the range, samples below it are counted apart.
+ * Counts are kept in an array of fixed capacity, so the histogram is copied into snapshots
+ * like other accumulators.
+ */
+class Histogram
+{
+public:
+    enum class Scale
+    {
+        Linear,
+        Logarithmic,
+        Adaptive
+    };
+
+    static constexpr int maxBins = 64;
+
+    Histogram() = default;
+
+    /**
+     * @throws std::runtime_error if the range is empty, the number of bins is not in <1, maxBins>
+     * or the logarithmic range is not positive
+     */
+    Histogram(double from, double to, int bins, Scale scale = Scale::Linear)
+        : m_scale{scale}
+        , m_bins{bins}
+    {
+        if (!(from < to) || bins < 1 || bins > maxBins)
+            throw std::runtime_error{"Histogram requires a non-empty range and 1 to 64 bins"};
+        if (scale == Scale::Logarithmic && !(from > 0.0))
+            throw std::runtime_error{"Logarithmic histogram requires a positive range"};
+        m_from = scale == Scale::Logarithmic ? std::log(from) : from;
+        m_width = ((scale == Scale::Logarithmic ? std::log(to) : to) - m_from) / bins;
+    }
+
+    void add(double sample, quint64 count = 1)
+    {
+        m_total += count;
+        if (m_scale == Scale::Adaptive)
+        {
+            while (std::isfinite(sample) && sample >= upperEdge(m_bins - 1))
+                widen();
+        }
+        const auto position = m_scale == Scale::Logarithmic
+                                  ? (sample > 0.0 ? (std::log(sample) - m_from) / m_width : -1.0)
+                                  : (sample - m_from) / m_width;
+        if (!(position >= 0.0))
+            m_below += count;
+        else if (position >= m_bins)
+            m_above += count;
+        else
+            m_counts[static_cast<int>(position)] += count;
+    }
+
+    void merge(const Histogram& other)
+    {
+        // samples of a bin are added at its center, bins of the same scale and range match exactly
+        if (m_scale == Scale::Adaptive)
+        {
+            while (m_width < other.m_width)
+                widen();
+        }
+        m_total += other.m_below + other.m_above;
+        m_below += other.m_below;
+        m_above += other.m_above;
+        for (int bin = 0; bin < other.m_bins; ++bin)
+        {
+            if (other.m_counts[bin] > 0)
+                add(other.center(bin), other.m_counts[bin]);
+        }
+    }
+
+    int bins() const { return m_bins; }
+    quint64 count(int bin) const { return m_counts[bin]; }
+    quint64 below() const { return m_below; }
+    quint64 above() const { return m_above; }
+    quint64 total() const { return m_total; }
+    bool isLogarithmic() const { return m_scale == Scale::Logarithmic; }
+
+    double lowerEdge(int bin) const { return edge(m_from + bin * m_width); }
+    double upperEdge(int bin) const { return edge(m_from + (bin + 1) * m_width); }
+    double center(int bin) const { return edge(m_from + (bin + 0.5) * m_width); }
+
+    QString toString() const
+    {
+        QStringList counts;
+        counts.reserve(m_bins);
+        for (int bin = 0; bin < m_bins; ++bin)
+            counts.append(QString::number(m_counts[bin]));
+        return QStringLiteral("[%1, %2): %3; below: %4, above: %5")
+            .arg(lowerEdge(0)).arg(upperEdge(m_bins - 1)).arg(counts.join(u' ')).arg(m_below).arg(m_above);
+    }
+
+    /**
+     * @brief toMap
+     * @return range and counts of bins for QML, counts as numbers
+     */
+    QVariantMap toMap() const
+    {
+        QVariantList counts;
+        counts.reserve(m_bins);
+        for (int bin = 0; bin < m_bins; ++bin)
+            counts.append(static_cast<double>(m_counts[bin]));
+        return {{"from", lowerEdge(0)},
+                {"to", upperEdge(m_bins - 1)},
+                {"counts", counts},
+                {"below", static_cast<double>(m_below)},
+                {"above", static_cast<double>(m_above)},
+                {"logarithmic", isLogarithmic()}};
+    }
+
+private:
+    double edge(double position) const
+    {
+        return m_scale == Scale::Logarithmic ? std::exp(position) : position;
+    }
+
+    void widen()
+    {
+        // bins 2i and 2i + 1 become the bin i, so histograms widened from the same start stay aligned
+        for (int bin = 0; bin < m_bins; ++bin)
+        {
+            const auto count = m_counts[bin];
+            m_counts[bin] = 0;
+            m_counts[bin / 2] += count;
+        }
+        m_width *= 2.0;
+    }
+
+private:
+    Scale m_scale = Scale::Adaptive;
+    int m_bins = 32;
+    double m_from = 0.0;
+    double m_width = 1.0;
+    quint64 m_below = 0;
+    quint64 m_above = 0;
+    quint64 m_total = 0;
+    std::array<quint64, maxBins> m_counts{};
+};
+
+
+// accumulators are copied bytewise into snapshots of statistics
+static_assert(std::is_trivially_copyable_v<Mean> && std::is_trivially_copyable_v<Extremes> &&
+              std::is_trivially_copyable_v<Quantile> && std::is_trivially_copyable_v<BatchMeans> &&
+              std::is_trivially_copyable_v<Histogram>);
+
+/**
+ * @brief isAccumulator
+ * @return true if the type is one of the accumulators
+ */
+inline bool isAccumulator(QMetaType type)
+{
+    return type == QMetaType::fromType<Mean>() || type == QMetaType::fromType<Extremes>() ||
+           type == QMetaType::fromType<Quantile>() || type == QMetaType::fromType<BatchMeans>() ||
+           type == QMetaType::fromType<Histogram>();
+}
+
+/**
+ * @brief estimate
+ * @return value and error of the accumulator stored in the variant, nothing for other types
+ */
+inline std::optional<Estimate> estimate(const QVariant& value)
+{
+    if (!QMetaType::canConvert(value.metaType(), QMetaType::fromType<Estimate>()))
+        return std::nullopt;
+    return value.value<Estimate>();
+}
+
+/**
+ * @brief registerConverters
+ * Conversions of accumulators to double (the value), Estimate and QString,
+ * so they can be watched, displayed and exported like numbers.
+ * Call once at startup of the application.
+ */
+inline void registerConverters()
+{
+    const auto registerNumeric = []<typename A>(std::type_identity<A>) {
+        QMetaType::registerConverter<A, double>(&A::value);
+        QMetaType::registerConverter<A, Estimate>(&A::estimate);
+        QMetaType::registerConverter<A, QString>([](const A& accumulator) { return accumulator.estimate().toString(); });
+    };
+    registerNumeric(std::type_identity<Mean>{});
+    registerNumeric(std::type_identity<Quantile>{});
+    registerNumeric(std::type_identity<BatchMeans>{});
+    QMetaType::registerConverter<Extremes, QString>(&Extremes::toString);
+    QMetaType::registerConverter<Histogram, QString>(&Histogram::toString);
+}
+
+}  // namespace api::accumulator
+
+
+Q_DECLARE_METATYPE(api::accumulator::Estimate)
+Q_DECLARE_METATYPE(api::accumulator::Mean)
+Q_DECLARE_METATYPE(api::accumulator::Extremes)
+Q_DECLARE_METATYPE(api::accumulator::Quantile)
+Q_DECLARE_METATYPE(api::accumulator::BatchMeans)
+Q_DECLARE_METATYPE(api::accumulator::Histogram)
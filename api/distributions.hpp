@@ -0,0 +1,523 @@
+#pragma once
+
+#include <QtGlobal>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "tools.hpp"
+
+
+/**
+ * Samplers of common distributions built on the fast path of NumberGenerator (uniform()),
+ * so sampling costs no virtual call per number. Samplers are cheap to copy, keep them
+ * as members prepared in setup() and use them in run(), e.g.
+ *      api::distribution::Exponential serviceTime{1.0 / meanServiceTime};
+ *      api::distribution::Poisson arrivals{arrivalsPerHour};
+ *      ...
+ *      const auto duration = serviceTime(generator);
+ *      serviceTime.fill(generator, durations);  // many numbers at once
+ * Invalid parameters throw std::runtime_error.
+ */
+namespace api::distribution
+{
+
+namespace detail
+{
+/**
+ * @brief The Ziggurat struct
+ * Layers of the ziggurat method (Marsaglia, Tsang) for a decreasing density f(x), x >= 0.
+ * Layer 0 is the base with the tail, x[i] is the width of the layer i, x[layers] = 0.
+ */
+template <std::size_t layers>
+struct Ziggurat
+{
+    std::array<double, layers + 1> x;
+    std::array<double, layers + 1> f;
+    std::array<double, layers> ratio;
+
+    template <typename Density, typename InverseDensity>
+    Ziggurat(double r, double v, Density density, InverseDensity inverseDensity)
+    {
+        x[0] = v / density(r);
+        x[1] = r;
+        for (std::size_t i = 2; i < layers; ++i)
+            x[i] = inverseDensity(v / x[i - 1] + density(x[i - 1]));
+        x[layers] = 0.0;
+        for (std::size_t i = 0; i <= layers; ++i)
+            f[i] = density(x[i]);
+        for (std::size_t i = 0; i < layers; ++i)
+            ratio[i] = x[i + 1] / x[i];
+    }
+};
+
+inline constexpr std::size_t zigguratLayers = 256;
+
+inline const Ziggurat<zigguratLayers>& normalZiggurat()
+{
+    static const auto ziggurat = Ziggurat<zigguratLayers>(
+        3.6541528853610088, 0.00492867323399,
+        [](double x) { return std::exp(-0.5 * x * x); },
+        [](double y) { return std::sqrt(-2.0 * std::log(y)); });
+    return ziggurat;
+}
+
+inline const Ziggurat<zigguratLayers>& exponentialZiggurat()
+{
+    static const auto ziggurat = Ziggurat<zigguratLayers>(
+        7.69711747013104972, 0.0039496598225815571993,
+        [](double x) { return std::exp(-x); },
+        [](double y) { return -std::log(y); });
+    return ziggurat;
+}
+
+/**
+ * @brief bits
+ * @return 53 random bits of one uniform number
+ * Low bits are zero for generators with less precision (Sobol gives 32 bits),
+ * so choices of the ziggurat are taken from the high bits.
+ */
+inline std::uint64_t bits(NumberGenerator& generator)
+{
+    return static_cast<std::uint64_t>(generator.uniform() * 9007199254740992.0);
+}
+
+/**
+ * @brief positiveUniform
+ * @return random real number in range (0, 1), safe for the logarithm
+ */
+inline double positiveUniform(NumberGenerator& generator)
+{
+    return 1.0 - generator.uniform();
+}
+}  // namespace detail
+
+
+/**
+ * @brief The Normal class
+ * Normal distribution, sampled with the ziggurat method
+ * (one uniform number per sample in about 99% of cases)
+ */
+class Normal
+{
+public:
+    explicit Normal(double mean = 0.0, double standardDeviation = 1.0)
+        : m_mean{mean}
+        , m_standardDeviation{standardDeviation}
+    {
+        if (!(standardDeviation > 0.0))
+            throw std::runtime_error{"Normal distribution requires a positive standard deviation"};
+        detail::normalZiggurat();
+    }
+
+    double operator()(NumberGenerator& generator) const
+    {
+        return m_mean + m_standardDeviation * standard(generator);
+    }
+
+    void fill(NumberGenerator& generator, std::span<double> values) const
+    {
+        for (auto& value : values)
+            value = (*this)(generator);
+    }
+
+    /**
+     * @brief standard
+     * @return sample of the standard normal distribution
+     */
+    static double standard(NumberGenerator& generator)
+    {
+        const auto& ziggurat = detail::normalZiggurat();
+        while (true)
+        {
+            // 8 high bits choose the layer, 1 bit the sign, 44 low bits the position in the layer
+            const auto bits = detail::bits(generator);
+            const auto layer = static_cast<std::size_t>(bits >> 45);
+            const auto sign = ((bits >> 44) & 1) ? -1.0 : 1.0;
+            const auto u = static_cast<double>(bits & 0xFFFFFFFFFFF) * (1.0 / 17592186044416.0);
+            if (u < ziggurat.ratio[layer])
+                return sign * u * ziggurat.x[layer];
+            if (layer == 0)
+            {
+                // tail beyond r (Marsaglia 1964)
+                const auto r = ziggurat.x[1];
+                double x = 0.0;
+                double y = 0.0;
+                do
+                {
+                    x = -std::log(detail::positiveUniform(generator)) / r;
+                    y = -std::log(detail::positiveUniform(generator));
+                } while (y + y < x * x);
+                return sign * (r + x);
+            }
+            const auto x = u * ziggurat.x[layer];
+            const auto f = ziggurat.f[layer + 1] + generator.uniform() * (ziggurat.f[layer] - ziggurat.f[layer + 1]);
+            if (f < std::exp(-0.5 * x * x))
+                return sign * x;
+        }
+    }
+
+private:
+    double m_mean;
+    double m_standardDeviation;
+};
+
+
+/**
+ * @brief The Exponential class
+ * Exponential distribution, sampled with the ziggurat method
+ */
+class Exponential
+{
+public:
+    explicit Exponential(double rate = 1.0)
+        : m_scale{1.0 / rate}
+    {
+        if (!(rate > 0.0))
+            throw std::runtime_error{"Exponential distribution requires a positive rate"};
+        detail::exponentialZiggurat();
+    }
+
+    double operator()(NumberGenerator& generator) const
+    {
+        return m_scale * standard(generator);
+    }
+
+    void fill(NumberGenerator& generator, std::span<double> values) const
+    {
+        for (auto& value : values)
+            value = (*this)(generator);
+    }
+
+    /**
+     * @brief standard
+     * @return sample of the exponential distribution with the rate 1
+     */
+    static double standard(NumberGenerator& generator)
+    {
+        const auto& ziggurat = detail::exponentialZiggurat();
+        while (true)
+        {
+            // 8 high bits choose the layer, 45 low bits the position in the layer
+            const auto bits = detail::bits(generator);
+            const auto layer = static_cast<std::size_t>(bits >> 45);
+            const auto u = static_cast<double>(bits & 0x1FFFFFFFFFFF) * (1.0 / 35184372088832.0);
+            if (u < ziggurat.ratio[layer])
+                return u * ziggurat.x[layer];
+            if (layer == 0)
+                return ziggurat.x[1] - std::log(detail::positiveUniform(generator));  // memoryless tail
+            const auto x = u * ziggurat.x[layer];
+            const auto f = ziggurat.f[layer + 1] + generator.uniform() * (ziggurat.f[layer] - ziggurat.f[layer + 1]);
+            if (f < std::exp(-x))
+                return x;
+        }
+    }
+
+private:
+    double m_scale;
+};
+
+
+/**
+ * @brief The Gamma class
+ * Gamma distribution with the shape k and the scale theta (Marsaglia, Tsang 2000)
+ */
+class Gamma
+{
+public:
+    explicit Gamma(double shape = 1.0, double scale = 1.0)
+        : m_shape{shape}
+        , m_scale{scale}
+        , m_d{(shape < 1.0 ? shape + 1.0 : shape) - 1.0 / 3.0}
+        , m_c{1.0 / std::sqrt(9.0 * m_d)}
+    {
+        if (!(shape > 0.0) || !(scale > 0.0))
+            throw std::runtime_error{"Gamma distribution requires a positive shape and scale"};
+    }
+
+    double operator()(NumberGenerator& generator) const
+    {
+        auto value = 0.0;
+        while (true)
+        {
+            const auto x = Normal::standard(generator);
+            auto v = 1.0 + m_c * x;
+            if (v <= 0.0)
+                continue;
+            v = v * v * v;
+            const auto u = detail::positiveUniform(generator);
+            if (u < 1.0 - 0.0331 * x * x * x * x || std::log(u) < 0.5 * x * x + m_d * (1.0 - v + std::log(v)))
+            {
+                value = m_d * v;
+                break;
+            }
+        }
+        // shape below 1 is boosted: Gamma(k) = Gamma(k + 1) * U^(1/k)
+        if (m_shape < 1.0)
+            value *= std::pow(detail::positiveUniform(generator), 1.0 / m_shape);
+        return m_scale * value;
+    }
+
+    void fill(NumberGenerator& generator, std::span<double> values) const
+    {
+        for (auto& value : values)
+            value = (*this)(generator);
+    }
+
+private:
+    double m_shape;
+    double m_scale;
+    double m_d;
+    double m_c;
+};
+
+
+/**
+ * @brief The Poisson class
+ * Poisson distribution, sampled by inversion for small means
+ * and by transformed rejection PTRS (Hörmann 1993) for means of 10 and more
+ */
+class Poisson
+{
+public:
+    explicit Poisson(double mean = 1.0)
+        : m_mean{mean}
+        , m_expMean{std::exp(-mean)}
+        , m_logMean{std::log(mean)}
+        , m_b{0.931 + 2.53 * std::sqrt(mean)}
+        , m_a{-0.059 + 0.02483 * m_b}
+        , m_logInverseAlpha{std::log(1.1239 + 1.1328 / (m_b - 3.4))}
+        , m_vr{0.9277 - 3.6224 / (m_b - 2.0)}
+    {
+        if (!(mean > 0.0))
+            throw std::runtime_error{"Poisson distribution requires a positive mean"};
+    }
+
+    qint64 operator()(NumberGenerator& generator) const
+    {
+        if (m_mean < 10.0)
+        {
+            auto u = generator.uniform();
+            auto probability = m_expMean;
+            qint64 k = 0;
+            while (u > probability && probability > 0.0)
+            {
+                u -= probability;
+                ++k;
+                probability *= m_mean / static_cast<double>(k);
+            }
+            return k;
+        }
+
+        while (true)
+        {
+            const auto u = generator.uniform() - 0.5;
+            const auto v = detail::positiveUniform(generator);
+            const auto us = 0.5 - std::abs(u);
+            const auto k = std::floor((2.0 * m_a / us + m_b) * u + m_mean + 0.43);
+            if (us >= 0.07 && v <= m_vr)
+                return static_cast<qint64>(k);
+            if (k < 0.0 || (us < 0.013 && v > us))
+                continue;
+            if (std::log(v) + m_logInverseAlpha - std::log(m_a / (us * us) + m_b) <=
+                -m_mean + k * m_logMean - std::lgamma(k + 1.0))
+                return static_cast<qint64>(k);
+        }
+    }
+
+    void fill(NumberGenerator& generator, std::span<qint64> values) const
+    {
+        for (auto& value : values)
+            value = (*this)(generator);
+    }
+
+private:
+    double m_mean;
+    double m_expMean;
+    double m_logMean;
+    double m_b;
+    double m_a;
+    double m_logInverseAlpha;
+    double m_vr;
+};
+
+
+/**
+ * @brief The Binomial class
+ * Binomial distribution of the number of successes in n trials, sampled by inversion
+ * for small means and by transformed rejection BTRS (Hörmann 1993) otherwise
+ */
+class Binomial
+{
+public:
+    Binomial(qint64 trials, double probability)
+        : m_trials{trials}
+        , m_isMirrored{probability > 0.5}
+        , m_p{m_isMirrored ? 1.0 - probability : probability}
+        , m_q{1.0 - m_p}
+    {
+        if (trials < 0 || !(0.0 <= probability && probability <= 1.0))
+            throw std::runtime_error{"Binomial distribution requires non-negative trials and probability in range <0, 1>"};
+
+        const auto n = static_cast<double>(trials);
+        m_isInversion = n * m_p < 10.0;
+        m_qPowN = std::pow(m_q, n);
+        m_odds = m_q > 0.0 ? m_p / m_q : 0.0;
+        const auto spq = std::sqrt(n * m_p * m_q);
+        m_b = 1.15 + 2.53 * spq;
+        m_a = -0.0873 + 0.0248 * m_b + 0.01 * m_p;
+        m_c = n * m_p + 0.5;
+        m_vr = 0.92 - 4.2 / m_b;
+        m_alpha = (2.83 + 5.1 / m_b) * spq;
+        m_logOdds = std::log(m_odds);
+        m_mode = std::floor((n + 1.0) * m_p);
+        m_h = std::lgamma(m_mode + 1.0) + std::lgamma(n - m_mode + 1.0);
+    }
+
+    qint64 operator()(NumberGenerator& generator) const
+    {
+        const auto successes = m_p == 0.0 ? 0 : (m_isInversion ? inversion(generator) : rejection(generator));
+        return m_isMirrored ? m_trials - successes : successes;
+    }
+
+    void fill(NumberGenerator& generator, std::span<qint64> values) const
+    {
+        for (auto& value : values)
+            value = (*this)(generator);
+    }
+
+private:
+    qint64 inversion(NumberGenerator& generator) const
+    {
+        while (true)
+        {
+            auto u = generator.uniform();
+            auto probability = m_qPowN;
+            qint64 k = 0;
+            const auto factor = static_cast<double>(m_trials + 1) * m_odds;
+            while (u > probability)
+            {
+                u -= probability;
+                ++k;
+                if (k > m_trials)
+                    break;
+                probability *= factor / static_cast<double>(k) - m_odds;
+            }
+            // rounding errors may leave u above the total probability, the draw is repeated
+            if (k <= m_trials)
+                return k;
+        }
+    }
+
+    qint64 rejection(NumberGenerator& generator) const
+    {
+        const auto n = static_cast<double>(m_trials);
+        while (true)
+        {
+            const auto u = generator.uniform() - 0.5;
+            auto v = detail::positiveUniform(generator);
+            const auto us = 0.5 - std::abs(u);
+            const auto k = std::floor((2.0 * m_a / us + m_b) * u + m_c);
+            if (k < 0.0 || k > n)
+                continue;
+            if (us >= 0.07 && v <= m_vr)
+                return static_cast<qint64>(k);
+            v = std::log(v * m_alpha / (m_a / (us * us) + m_b));
+            if (v <= m_h - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0) + (k - m_mode) * m_logOdds)
+                return static_cast<qint64>(k);
+        }
+    }
+
+private:
+    qint64 m_trials;
+    bool m_isMirrored;
+    bool m_isInversion;
+    double m_p;
+    double m_q;
+    double m_qPowN;
+    double m_odds;
+    double m_b;
+    double m_a;
+    double m_c;
+    double m_vr;
+    double m_alpha;
+    double m_logOdds;
+    double m_mode;
+    double m_h;
+};
+
+
+/**
+ * @brief The Discrete class
+ * Empirical distribution of indices 0..n-1 with given weights,
+ * sampled in constant time with the alias table (Vose 1991)
+ */
+class Discrete
+{
+public:
+    explicit Discrete(std::span<const double> weights)
+        : m_probability(weights.size())
+        , m_alias(weights.size())
+    {
+        const auto total = std::accumulate(weights.begin(), weights.end(), 0.0);
+        if (weights.empty() || !(total > 0.0) ||
+            std::any_of(weights.begin(), weights.end(), [](double weight) { return !(weight >= 0.0); }))
+            throw std::runtime_error{"Discrete distribution requires non-negative weights with a positive sum"};
+
+        const auto n = weights.size();
+        auto scaled = std::vector<double>(n);
+        auto small = std::vector<std::size_t>{};
+        auto large = std::vector<std::size_t>{};
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            scaled[i] = weights[i] * static_cast<double>(n) / total;
+            (scaled[i] < 1.0 ? small : large).push_back(i);
+        }
+        while (!small.empty() && !large.empty())
+        {
+            const auto less = small.back();
+            const auto more = large.back();
+            small.pop_back();
+            m_probability[less] = scaled[less];
+            m_alias[less] = more;
+            scaled[more] -= 1.0 - scaled[less];
+            if (scaled[more] < 1.0)
+            {
+                large.pop_back();
+                small.push_back(more);
+            }
+        }
+        // leftovers differ from 1 only by rounding errors
+        for (auto i : large)
+            m_probability[i] = 1.0;
+        for (auto i : small)
+            m_probability[i] = 1.0;
+    }
+
+    std::size_t operator()(NumberGenerator& generator) const
+    {
+        // one uniform number chooses both the column and the side of the column
+        const auto u = generator.uniform() * static_cast<double>(m_probability.size());
+        const auto column = static_cast<std::size_t>(u);
+        return u - static_cast<double>(column) < m_probability[column] ? column : m_alias[column];
+    }
+
+    void fill(NumberGenerator& generator, std::span<std::size_t> values) const
+    {
+        for (auto& value : values)
+            value = (*this)(generator);
+    }
+
+    std::size_t size() const { return m_probability.size(); }
+
+private:
+    std::vector<double> m_probability;
+    std::vector<std::size_t> m_alias;
+};
+
+}  // namespace api::distribution
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <QImage>
+#include <QMutex>
+#include <QMutexLocker>
+#include <array>
+#include <cstring>
+#include <optional>
+
+
+namespace api
+{
+
+/**
+ * @brief The FrameExchange class
+ * Passes animation frames from the simulation thread to the GUI thread.
+ * The simulation keeps drawing into its own image, which is never shared,
+ * so painting does not detach it. Completed frames are copied into one of
+ * a few preallocated frames that is not used by the GUI anymore, the GUI
+ * takes only the latest completed frame and frames it did not take are reused.
+ */
+class FrameExchange
+{
+public:
+    static constexpr std::size_t frames = 3;
+
+public:
+    /**
+     * @brief reset
+     * Forgets the last published frame, the next one is published even if it did not change
+     */
+    void reset()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_publishedKey.reset();
+        m_isFresh = false;
+    }
+
+    /**
+     * @brief publish
+     * Called by the simulation thread when the frame is complete,
+     * does nothing if the image has not been modified since the last publish
+     */
+    void publish(const QImage& image)
+    {
+        // every modification of the image changes its cache key
+        if (m_publishedKey == image.cacheKey())
+            return;
+        m_publishedKey = image.cacheKey();
+
+        QMutexLocker locker(&m_mutex);
+        // a frame taken by the GUI is shared, writing it would detach it
+        auto target = m_isFresh ? m_ready : frames;
+        for (std::size_t i = 0; i < frames && target == frames; ++i)
+        {
+            if (i != m_ready && (m_frames[i].isNull() || m_frames[i].isDetached()))
+                target = i;
+        }
+        if (target == frames)
+            target = (m_ready + 1) % frames;
+
+        auto& frame = m_frames[target];
+        if (image.isNull())
+            frame = QImage();
+        else if (frame.size() != image.size() || frame.format() != image.format() || !frame.isDetached()
+                 || frame.bytesPerLine() != image.bytesPerLine() || !image.colorTable().isEmpty())
+            frame = image.copy();
+        else
+            std::memcpy(frame.bits(), image.constBits(), static_cast<std::size_t>(image.sizeInBytes()));
+        m_ready = target;
+        m_isFresh = true;
+    }
+
+    /**
+     * @brief take
+     * Called by the GUI thread
+     * @return latest completed frame, nothing if there is no new frame since the last call
+     */
+    std::optional<QImage> take()
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_isFresh)
+            return std::nullopt;
+        m_isFresh = false;
+        return m_frames[m_ready];
+    }
+
+private:
+    QMutex m_mutex;
+    std::array<QImage, frames> m_frames;
+    std::size_t m_ready = 0;
+    bool m_isFresh = false;
+    // accessed only by the simulation thread
+    std::optional<qint64> m_publishedKey;
+};
+
+}  // namespace api
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QList>
+#include <QMetaType>
+#include <QRectF>
+#include <algorithm>
+#include <cmath>
+
+
+namespace api
+{
+
+/**
+ * @brief The Heatmap struct
+ * Two-dimensional histogram of samples over an area of the animation image.
+ * For very many samples the density is shown instead of single points,
+ * the UI sums counts of all batches and maps them to colors (log scale),
+ * so the cost of a frame depends on the size of the grid, not on the number of samples.
+ */
+struct Heatmap
+{
+    QRectF area;  // in pixel coordinates of the animation image
+    int columns = 0;
+    int rows = 0;
+    QList<quint32> counts;  // row by row, samples added since the previous batch, empty if none
+
+    bool isValid() const { return columns > 0 && rows > 0 && !area.isEmpty(); }
+
+    /**
+     * @brief add
+     * Adds the sample in pixel coordinates of the image, samples outside of the area are skipped
+     */
+    void add(double x, double y)
+    {
+        // the range is checked before the conversion, which is undefined for values out of int
+        if (!isValid() || !std::isfinite(x) || !std::isfinite(y) || x < area.left() || x >= area.right() || y < area.top() || y >= area.bottom())
+            return;
+        const auto column = std::min(static_cast<int>((x - area.left()) * columns / area.width()), columns - 1);
+        const auto row = std::min(static_cast<int>((y - area.top()) * rows / area.height()), rows - 1);
+        if (counts.isEmpty())
+            counts.resize(static_cast<qsizetype>(columns) * rows, 0);
+        ++counts[static_cast<qsizetype>(row) * columns + column];
+    }
+};
+
+}  // namespace api
+
+
+Q_DECLARE_METATYPE(api::Heatmap)
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+
+#include "variable.hpp"
+
+
+/**
+ * Helpers for ISimulationDLL::merge(), combining statistics of simulation
+ * instances run in parallel. The 'total' statistics start from the default
+ * values and every instance is merged into them one by one, e.g.
+ *      const auto trials = total.ref<int>("Trials");
+ *      const auto partialTrials = partial.get<int>("Trials");
+ *      api::merge::weightedMean<double>(total, partial, "Average", trials, partialTrials);
+ *      api::merge::sum<int>(total, partial, "Trials");
+ *      api::merge::maximum<int>(total, partial, "Longest series");
+ *      api::merge::accumulate<api::accumulator::Mean>(total, partial, "Waiting time");
+ */
+namespace api::merge
+{
+
+/**
+ * @brief sum
+ * Counters and totals, the merged value is a sum of all values
+ */
+template <typename T>
+inline void sum(VariableMap& total, const VariableWatchList& partial, const QString& name)
+{
+    total.ref<T>(name) += partial.get<T>(name);
+}
+
+/**
+ * @brief maximum
+ * Extremes, the merged value is the greatest of all values
+ */
+template <typename T>
+inline void maximum(VariableMap& total, const VariableWatchList& partial, const QString& name)
+{
+    auto& value = total.ref<T>(name);
+    value = std::max(value, partial.get<T>(name));
+}
+
+/**
+ * @brief accumulate
+ * Accumulators (see api/accumulators.hpp), the merged state is the same
+ * as if all samples were added to one accumulator, up to rounding
+ */
+template <typename T>
+inline void accumulate(VariableMap& total, const VariableWatchList& partial, const QString& name)
+{
+    total.ref<T>(name).merge(partial.get<T>(name));
+}
+
+/**
+ * @brief weightedMean
+ * Means, combined with weights equal to the number of samples
+ * they were computed from. 'totalWeight' must not include 'partialWeight'.
+ * The result equals the mean of all samples up to rounding, which depends on the order of merging.
+ */
+template <typename T, typename W>
+inline void weightedMean(VariableMap& total, const VariableWatchList& partial, const QString& name,
+                         W totalWeight, W partialWeight)
+{
+    if (totalWeight + partialWeight == 0)
+        return;
+    auto& value = total.ref<T>(name);
+    value = static_cast<T>((static_cast<double>(value) * static_cast<double>(totalWeight) +
+                            static_cast<double>(partial.get<T>(name)) * static_cast<double>(partialWeight)) /
+                           static_cast<double>(totalWeight + partialWeight));
+}
+
+}  // namespace api::merge
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QList>
+#include <QMetaType>
+#include <QRgb>
+
+
+namespace api
+{
+
+/**
+ * @brief The Point struct
+ * Single colored point of the animation, in pixel coordinates of the animation image.
+ * Points are streamed to the UI and drawn by the GPU on top of the image,
+ * so drawing many of them does not repaint nor upload the whole image.
+ */
+struct Point
+{
+    float x;
+    float y;
+    QRgb color;
+};
+
+/**
+ * @brief Points
+ * Points drawn since the previous batch, implicitly shared, so passing them between threads is cheap
+ */
+using Points = QList<Point>;
+
+}  // namespace api
+
+
+Q_DECLARE_METATYPE(api::Points)
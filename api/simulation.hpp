@@ -28,6 +28,14 @@
  *      Extends SimpleSimulation by adding an image rendered in the UI.
  *      Your run() implementation must update both 'stats' and the 'image'
  *      if you want animation frames to be displayed.
+ *      Draw the static background on the 'image' in setup() and add single points
+ *      in run() with drawPoint(x, y, color), in pixel coordinates of the image.
+ *      Only new points are sent to the UI and drawn by the GPU over the image,
+ *      painting them on the image would copy and upload the whole image every frame.
+ *      For millions of samples call setHeatmap() in setup() and addSample(x, y) in run(),
+ *      the UI shows the density of samples instead of single points.
+ *      The 'image' is never shared with the UI, it is copied into a free frame buffer
+ *      after a batch only if it was modified, and the UI displays the latest frame.
  *
  * Required methods in your simulation class:
  *      - setup(VariableWatchList properties) : void
@@ -37,6 +45,8 @@
  *                  properties.get<int>("Parameter:Param 1")
  *
  *      - run(api::NumberGenerator* generator) : void
+ *          Called repeatedly, usually in batches of many iterations executed
+ *          one after another on the simulation thread.
  *          Executes simulation logic and updates statistics declared in
  *          ISimulationDLL::statistics(). Access statistics by reference, e.g.:
  *              auto* trials = stats.ref<int>("Trials");
@@ -45,6 +55,10 @@
  *          internal statistics used by the framework.
  *          The provided NumberGenerator must be used for randomness—do not use
  *          standard C++ random generators, otherwise UI configuration may not work.
+ *          In tight loops prefer the non-virtual fast path generator.uniform() and
+ *          generator.uniformInt(from, to), or fill() for many numbers at once.
+ *          Normal, exponential, gamma, Poisson, binomial and discrete (weighted)
+ *          numbers are sampled with api/distributions.hpp.
  *          If a fatal error occurs, emit error(message) and return immediately.
  *
  *      - teardown() : void
@@ -64,7 +78,13 @@
  *          api::var<int>("Wins", "Won games", 0),
  *          api::var<int>("Losses", "Lost games", 0));
  *
- *      The supported variable types are: bool, int, double, QString
+ *      The supported variable types are: bool, int, qint64, quint64, double, QString
+ *      Other types known to QMetaType (e.g. QColor, QPointF, QTime) are kept as QVariant,
+ *      they work the same way, only copying their values is slower.
+ *      Use qint64 for counters of iterations, long runs exceed the range of int.
+ *      Statistics may also be accumulators of samples (see api/accumulators.hpp):
+ *      mean with standard error, extremes, quantiles and batch means of correlated samples,
+ *      updated with add() in run() and shown as value ± error, or histograms shown as bar charts.
  *
  *      In setup(), read properties via:
  *                  name :      properties.get<T>("Param 1")
@@ -72,6 +92,10 @@
  *                  fullname:   properties.get<T>("Root Group:Parameter:Param 1")
  *      In run(), update statistics via stats.ref<T>("Wins"), which returns a REFERENCE
  *      that MUST BE modified to change the stored values.
+ *      Name lookups are slow, resolve statistics once in setup() with typed handles:
+ *                  api::StatHandle<int> wins;              // member of the simulation
+ *                  wins = stats.handle<int>("Wins");       // in setup()
+ *                  ++(*wins);                              // in run()
  *
  *      Use subname or fullname to distinguish between variables with the same name but
  *      belonging to different groups.
@@ -80,6 +104,10 @@
  * Optional:
  *      - emit progress(stats) from run() if you need more frequent UI/statistics updates.
  *      - emit error(message) and stop immediately if an unrecoverable error occurs.
+ *      - override ISimulationDLL::merge() to allow running many instances of the simulation
+ *        in parallel, see api/merge.hpp for helpers combining typical statistics.
+ *      - override saveState() and restoreState() if run() keeps state outside of 'stats',
+ *        so that long simulations can be resumed from a checkpoint with identical results.
  *
  * 3. Do NOT emit _setupFinished, _runFinished, or _teardownFinished.
  *    These are internal framework signals.
@@ -89,9 +117,14 @@
 #include <QObject>
 #include <QString>
 #include <QImage>
+#include <utility>
 
 #include "variable.hpp"
+#include "merge.hpp"
 #include "tools.hpp"
+#include "points.hpp"
+#include "heatmap.hpp"
+#include "frameexchange.hpp"
 
 
 namespace api
@@ -102,7 +135,12 @@ class ISimulation : public QObject
     Q_OBJECT
 
 public:
-    using QObject::QObject;
+    explicit ISimulation(QObject* parent = nullptr)
+        : QObject(parent)
+    {
+        // batched runs must stop as soon as the simulation reports an error
+        QObject::connect(this, &ISimulation::error, this, [this]() { m_errorReported = true; }, Qt::DirectConnection);
+    }
 
 public:
     /**
@@ -132,6 +170,22 @@ public:
      */
     virtual void teardown() = 0;
 
+    /**
+     * @brief saveState
+     * Optional. Saves the state kept by the simulation outside of statistics,
+     * e.g. sums or counters used in run(). Statistics and random numbers are saved by the framework.
+     * Called between runs, when the simulation is checkpointed.
+     * @return serialized state, e.g. written with QDataStream
+     */
+    virtual QByteArray saveState() const { return {}; }
+
+    /**
+     * @brief restoreState
+     * Optional. Restores the state saved by saveState(), called after setup()
+     * when the simulation is resumed from a checkpoint.
+     */
+    virtual void restoreState(const QByteArray& state) {}
+
 signals:
     /**
      * @brief error
@@ -146,11 +200,15 @@ signals:
      * @brief progress
      * @param changes
      * statistics are automatically update
-     * at the end of the run function
+     * at the end of the batch of runs
      * if you need to update it more frequently just call
      * emit progress(stats)
      */
     void progress(const VariableMap::Snapshot& changes);
+
+protected:
+    // --- Do not use variables below in your code --
+    bool m_errorReported = false;
 };
 
 
@@ -206,7 +264,7 @@ public:
     /**
      * @brief statistics
      * Statistics are collected during simulation runs.
-     * Their values are updated after each run() and on explicit command (using: emit progress(stats)).
+     * Their values are updated after each batch of run() calls and on explicit command (using: emit progress(stats)).
      * To update statistics, the user should enter the appropriate values during the run().
      *
      * Statistics use the same variable system as properties (see above)
@@ -216,6 +274,24 @@ public:
      * @return variables describing the statistics of your simulation
      */
     virtual Variables statistics() const = 0;
+
+    /**
+     * @brief merge
+     * Optional. Allows running many independent instances of your simulation in parallel.
+     * The framework calls merge() for every instance, combining its statistics into 'total',
+     * which starts from the default values of statistics(). Update 'total' by reference,
+     * the same way as 'stats' in run(), e.g.:
+     *     api::merge::sum<int>(total, partial, "Trials");
+     * Before the first run the framework calls merge() once with default statistics
+     * to check whether merging is supported.
+     * @param total statistics combined so far
+     * @param partial statistics of a single simulation instance
+     * @return false if statistics cannot be merged (default), then the simulation runs on a single thread
+     */
+    virtual bool merge(VariableMap& total, const VariableWatchList& partial) const
+    {
+        return false;
+    }
 };
 
 
@@ -231,6 +307,7 @@ public slots:
     {
         try
         {
+            m_errorReported = false;
             stats.reinitialize(statistics);
             stats.reset();
             setup(VariableMap(properties).watch());
@@ -253,6 +330,36 @@ public slots:
             emit error(QString("An exception occured during SimpleSimulation run:\n%1").arg(e.what()));
         }
     }
+    void _runBatch(NumberGenerator* generator, qint64 firstIteration, qint64 iterations)
+    {
+        try
+        {
+            generator->beginBatch(firstIteration, iterations);
+            for (qint64 i = 0; i < iterations && !m_errorReported; ++i)
+            {
+                generator->beginIteration(firstIteration + i);
+                run(*generator);
+            }
+            if (!m_errorReported)
+                emit _runFinished(stats);
+        }
+        catch (std::exception& e)
+        {
+            emit error(QString("An exception occured during SimpleSimulation run:\n%1").arg(e.what()));
+        }
+    }
+    void _restore(const VariableMap::Snapshot& statistics, const QByteArray& state)
+    {
+        try
+        {
+            stats.restore(statistics);
+            restoreState(state);
+        }
+        catch (std::exception& e)
+        {
+            emit error(QString("An exception occured during SimpleSimulation restore:\n%1").arg(e.what()));
+        }
+    }
     void _teardown()
     {
         try
@@ -277,7 +384,7 @@ signals:
 
     /**
      * @brief _runFinished
-     * emitted at the end of the run,
+     * emitted at the end of the run or the batch of runs,
      * do not use it in your code
      */
     void _runFinished(const VariableMap::Snapshot& changes);
@@ -306,10 +413,15 @@ public slots:
     {
         try
         {
+            m_errorReported = false;
             stats.reinitialize(statistics);
             stats.reset();
+            m_points.clear();
+            m_heatmap = {};
             setup(VariableMap(properties).watch());
-            emit _setupFinished(stats, image);
+            m_frames.reset();
+            m_frames.publish(image);
+            emit _setupFinished(stats, std::exchange(m_points, {}), takeHeatmap());
         }
         catch (std::exception& e)
         {
@@ -321,13 +433,47 @@ public slots:
         try
         {
             run(*generator);
-            emit _runFinished(stats, image);
+            m_frames.publish(image);
+            emit _runFinished(stats, std::exchange(m_points, {}), takeHeatmap());
+        }
+        catch (std::exception& e)
+        {
+            emit error(QString("An exception occured during AnimatedSimulation run:\n%1").arg(e.what()));
+        }
+    }
+    void _runBatch(NumberGenerator* generator, qint64 firstIteration, qint64 iterations)
+    {
+        try
+        {
+            generator->beginBatch(firstIteration, iterations);
+            for (qint64 i = 0; i < iterations && !m_errorReported; ++i)
+            {
+                generator->beginIteration(firstIteration + i);
+                run(*generator);
+            }
+            if (!m_errorReported)
+            {
+                m_frames.publish(image);
+                emit _runFinished(stats, std::exchange(m_points, {}), takeHeatmap());
+            }
         }
         catch (std::exception& e)
         {
             emit error(QString("An exception occured during AnimatedSimulation run:\n%1").arg(e.what()));
         }
     }
+    void _restore(const VariableMap::Snapshot& statistics, const QByteArray& state)
+    {
+        try
+        {
+            stats.restore(statistics);
+            restoreState(state);
+        }
+        catch (std::exception& e)
+        {
+            emit error(QString("An exception occured during AnimatedSimulation restore:\n%1").arg(e.what()));
+        }
+    }
     void _teardown()
     {
         try
@@ -341,6 +487,18 @@ public slots:
         }
     }
 
+public:
+    /**
+     * @brief _takeFrame
+     * called by the framework from the GUI thread after _setupFinished or _runFinished,
+     * do not use it in your code
+     * @return latest completed image, nothing if it did not change
+     */
+    std::optional<QImage> _takeFrame()
+    {
+        return m_frames.take();
+    }
+
 signals:
     // --- Do not use signals below in your code --
     /**
@@ -348,14 +506,14 @@ signals:
      * emitted at the end of setup stage,
      * do not use it in your code
      */
-    void _setupFinished(const VariableMap::Snapshot& clearStats, const QImage& image);
+    void _setupFinished(const VariableMap::Snapshot& clearStats, const Points& points, const Heatmap& heatmap);
 
     /**
      * @brief _runFinished
-     * emitted at the end of the run,
+     * emitted at the end of the run or the batch of runs,
      * do not use it in your code
      */
-    void _runFinished(const VariableMap::Snapshot& changes, const QImage& image);
+    void _runFinished(const VariableMap::Snapshot& changes, const Points& points, const Heatmap& heatmap);
 
     /**
      * @brief _teardownFinished
@@ -364,9 +522,58 @@ signals:
      */
     void _teardownFinished();
 
+protected:
+    /**
+     * @brief drawPoint
+     * Adds the point drawn over the image, see api::Point
+     * @param x horizontal pixel coordinate of the image
+     * @param y vertical pixel coordinate of the image
+     * @param color color of the point
+     */
+    void drawPoint(double x, double y, QRgb color)
+    {
+        m_points.append({static_cast<float>(x), static_cast<float>(y), color});
+    }
+
+    /**
+     * @brief setHeatmap
+     * Enables the density map over the area of the image, call it in setup(), see api::Heatmap
+     * @param area area of the map in pixel coordinates of the image
+     * @param columns number of cells in a row
+     * @param rows number of cells in a column
+     */
+    void setHeatmap(const QRectF& area, int columns, int rows)
+    {
+        m_heatmap = Heatmap{area, columns, rows, {}};
+    }
+
+    /**
+     * @brief addSample
+     * Adds the sample to the density map, use it instead of drawPoint() for millions of samples
+     * @param x horizontal pixel coordinate of the image
+     * @param y vertical pixel coordinate of the image
+     */
+    void addSample(double x, double y)
+    {
+        m_heatmap.add(x, y);
+    }
+
 protected:
     VariableMap stats;
     QImage image;
+
+private:
+    Heatmap takeHeatmap()
+    {
+        auto heatmap = m_heatmap;
+        m_heatmap.counts.clear();
+        return heatmap;
+    }
+
+private:
+    Points m_points;
+    Heatmap m_heatmap;
+    FrameExchange m_frames;
 };
 
 
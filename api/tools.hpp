@@ -1,6 +1,13 @@
 #pragma once
 
+#include <QByteArray>
+#include <QDataStream>
+#include <QIODevice>
 #include <QObject>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
 
 
 namespace api
@@ -39,6 +46,197 @@ public:
      * @return random real number in range <from, to>
      */
     virtual double real(double from, double to) = 0;
+
+    /**
+     * @brief fill
+     * Fills all values with random real numbers in range <from, to) in one call
+     */
+    virtual void fill(std::span<double> values, double from, double to)
+    {
+        for (auto& value : values)
+            value = real(from, to);
+    }
+
+    /**
+     * @brief fill
+     * Fills all values with random integers in range <from, to> in one call
+     */
+    virtual void fill(std::span<int> values, int from, int to)
+    {
+        for (auto& value : values)
+            value = (*this)(from, to);
+    }
+
+    /**
+     * @brief uniform
+     * Fast path for tight loops, not virtual and inlined.
+     * Numbers are generated in blocks by fill() and taken from the buffer.
+     * @return random real number in range <0, 1)
+     */
+    double uniform()
+    {
+        if (m_position == m_size)
+            refill();
+        return m_buffer[m_position++];
+    }
+
+    /**
+     * @brief uniform
+     * Fast path, see uniform()
+     * @return random real number in range <from, to)
+     */
+    double uniform(double from, double to)
+    {
+        return from + (to - from) * uniform();
+    }
+
+    /**
+     * @brief uniformInt
+     * Fast path, see uniform(). The bias of the result is below (to - from) / 2^53.
+     * @return random integer in range <from, to>
+     */
+    int uniformInt(int from, int to)
+    {
+        const auto range = static_cast<double>(static_cast<qint64>(to) - from + 1);
+        const auto offset = static_cast<qint64>(uniform() * range);
+        return static_cast<int>(std::min<qint64>(from + offset, to));
+    }
+
+    /**
+     * @brief point
+     * Fills coordinates of a random point in the unit cube of dimension coordinates.size().
+     * Quasi-random generators (Sobol, Halton) return the point of the sequence
+     * assigned to the current iteration, request the whole point at the beginning of run().
+     */
+    void point(std::span<double> coordinates)
+    {
+        for (auto& coordinate : coordinates)
+            coordinate = uniform();
+    }
+
+    /**
+     * @brief beginIteration
+     * Called by the framework before every iteration of the simulation with its index,
+     * counter-based generators start the numbers of the iteration (see setIteration())
+     */
+    void beginIteration(qint64 iteration)
+    {
+        if (m_isCounterBased)
+        {
+            m_position = m_size;
+            setIteration(iteration);
+        }
+    }
+
+    /**
+     * @brief beginBatch
+     * Called by the framework before every batch of iterations
+     * @param firstIteration index of the first iteration of the batch
+     * @param iterations number of iterations in the batch
+     */
+    void beginBatch(qint64 firstIteration, qint64 iterations)
+    {
+        setBatch(firstIteration, iterations);
+    }
+
+    /**
+     * @brief saveState
+     * @return state of the generator with its buffered numbers, empty if the generator cannot be restored
+     */
+    QByteArray saveState() const
+    {
+        const auto engine = saveEngineState();
+        if (engine.isEmpty())
+            return {};
+        QByteArray state;
+        QDataStream stream(&state, QIODevice::WriteOnly);
+        stream << engine << static_cast<quint32>(m_size - m_position);
+        for (auto i = m_position; i < m_size; ++i)
+            stream << m_buffer[i];
+        return state;
+    }
+
+    /**
+     * @brief restoreState
+     * Continues the sequence of numbers from the saved state
+     * @return false if the state cannot be restored
+     */
+    bool restoreState(const QByteArray& state)
+    {
+        QDataStream stream(state);
+        QByteArray engine;
+        quint32 buffered = 0;
+        stream >> engine >> buffered;
+        if (stream.status() != QDataStream::Ok || buffered > m_buffer.size() || !restoreEngineState(engine))
+            return false;
+        for (quint32 i = 0; i < buffered; ++i)
+            stream >> m_buffer[i];
+        m_position = 0;
+        m_size = buffered;
+        return stream.status() == QDataStream::Ok;
+    }
+
+protected:
+    /**
+     * @brief setCounterBased
+     * Marks the generator as counter-based, its numbers depend on the iteration index.
+     * Buffered numbers are discarded at every iteration, so they are generated in small blocks.
+     * @param blockSize number of values generated at once for the fast path
+     */
+    void setCounterBased(std::size_t blockSize)
+    {
+        m_isCounterBased = true;
+        m_blockSize = std::clamp<std::size_t>(blockSize, 1, m_buffer.size());
+    }
+
+    /**
+     * @brief toUnitInterval
+     * @return real number in range <0, 1) with 53 random bits taken from two 32-bit words
+     */
+    static double toUnitInterval(quint32 high, quint32 low)
+    {
+        return ((high >> 5) * 67108864.0 + (low >> 6)) * (1.0 / 9007199254740992.0);
+    }
+
+    /**
+     * @brief setIteration
+     * Called before every iteration of counter-based generators,
+     * they compute numbers of the iteration from the seed and the index
+     */
+    virtual void setIteration(qint64 iteration) {}
+
+    /**
+     * @brief setBatch
+     * Called before every batch, generators drawing numbers for the whole batch prepare them here
+     */
+    virtual void setBatch(qint64 firstIteration, qint64 iterations) {}
+
+    /**
+     * @brief saveEngineState
+     * @return state of the engine, empty if the engine cannot be restored
+     */
+    virtual QByteArray saveEngineState() const { return {}; }
+
+    /**
+     * @brief restoreEngineState
+     * @return false if the state cannot be restored
+     */
+    virtual bool restoreEngineState(const QByteArray& state) { return false; }
+
+private:
+    void refill()
+    {
+        fill(std::span<double>(m_buffer.data(), m_blockSize), 0.0, 1.0);
+        m_position = 0;
+        m_size = m_blockSize;
+    }
+
+private:
+    std::array<double, 256> m_buffer{};
+    std::size_t m_position = 0;
+    std::size_t m_size = 0;
+    std::size_t m_blockSize = 256;
+    bool m_isCounterBased = false;
 };
 
 }  // namespace api
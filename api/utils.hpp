@@ -6,11 +6,16 @@
 namespace api::utils
 {
 
-template <typename T> inline bool convert(const QVariant& v);
+template <typename T> inline bool convert(const QVariant& v)
+{ return v.canConvert<T>(); }
 template <> inline bool convert<int>(const QVariant& v)
 { bool ok = false; v.toInt(&ok); return ok; }
 template <> inline bool convert<unsigned>(const QVariant& v)
 { bool ok = false; v.toUInt(&ok); return ok; }
+template <> inline bool convert<qint64>(const QVariant& v)
+{ bool ok = false; v.toLongLong(&ok); return ok; }
+template <> inline bool convert<quint64>(const QVariant& v)
+{ bool ok = false; v.toULongLong(&ok); return ok; }
 template <> inline bool convert<double>(const QVariant& v)
 { bool ok = false; v.toDouble(&ok); return ok; }
 template <> inline bool convert<bool>(const QVariant& v)
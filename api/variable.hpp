@@ -1,9 +1,16 @@
 #pragma once
 
+#include <QDataStream>
+#include <QHash>
 #include <QObject>
+#include <QSet>
 #include <QVariant>
+#include <algorithm>
+#include <cstring>
 #include <format>
+#include <memory>
 
+#include "accumulators.hpp"
 #include "utils.hpp"
 
 
@@ -51,14 +58,15 @@ public:
     // because of QObject::children, cannot name the method children()
     virtual QList<IHierarchicalNamedVariable*> inner() = 0;
 
+    // deep copy with current values, the caller takes the ownership
+    virtual IHierarchicalNamedVariable* clone() const = 0;
+
     QString fullName() const override
     {
-        if (this->parent())
-        {
-            if (auto variableParent = dynamic_cast<INamedVariable*>(this->parent()))
-                return QString("%1:%2").arg(variableParent->fullName(), name());
-        }
-        return name();
+        // cached when the tree is assembled, see assign()
+        if (m_isFullNameCached)
+            return m_fullName;
+        return composeFullName();
     }
 
     template <typename Container, typename Filter>
@@ -75,15 +83,31 @@ public:
 protected:
     void assign(int& newId)
     {
+        // parents are assigned before children, so the full name of the parent is already cached
         m_id = newId++;
+        m_fullName = composeFullName();
+        m_isFullNameCached = true;
         for (const auto& child : this->inner())
         {
             child->assign(newId);
         }
     }
 
+private:
+    QString composeFullName() const
+    {
+        if (this->parent())
+        {
+            if (auto variableParent = dynamic_cast<INamedVariable*>(this->parent()))
+                return variableParent->fullName() + ':' + name();
+        }
+        return name();
+    }
+
 private:
     int m_id = 0;
+    QString m_fullName;
+    bool m_isFullNameCached = false;
 };
 
 
@@ -112,6 +136,7 @@ public:
     virtual QVariant get() const override = 0;
     virtual void* dataPointer() const override = 0;
     virtual QList<IHierarchicalNamedVariable*> inner() override = 0;
+    virtual IVariable* clone() const override = 0;
 
 private:
     const QString m_name;
@@ -154,7 +179,7 @@ public:
 
     QVariant get() const override
     {
-        return QVariant{m_data};
+        return QVariant::fromValue(m_data);
     }
 
     void* dataPointer() const override
@@ -164,10 +189,15 @@ public:
 
     QList<IHierarchicalNamedVariable*> inner() override { return {}; }
 
+    IVariable* clone() const override
+    {
+        auto result = new Variable<T>(name(), description(), m_defaultValue);
+        result->m_data = m_data;
+        return result;
+    }
+
 protected:
     T m_data;
-
-private:
     T m_defaultValue;
 };
 
@@ -202,6 +232,13 @@ public:
         return false;
     }
 
+    IVariable* clone() const override
+    {
+        auto result = new VariableFiltered<T>(this->name(), this->description(), this->m_defaultValue, m_filter);
+        result->m_data = this->m_data;
+        return result;
+    }
+
 private:
     Filter m_filter;
 };
@@ -242,6 +279,19 @@ public:
     void* dataPointer() const final { return nullptr; }
     QList<IHierarchicalNamedVariable*> inner() override { return m_properties; }
 
+    IVariable* clone() const override
+    {
+        auto result = new VariableGroup(name(), nullptr);
+        result->m_properties.reserve(m_properties.size());
+        for (const auto& property : m_properties)
+        {
+            result->m_properties.append(utils::withParent(property->clone(), result));
+        }
+        int id = 0;
+        result->assign(id);
+        return result;
+    }
+
 private:
     QList<IHierarchicalNamedVariable*> m_properties;
 };
@@ -250,79 +300,248 @@ private:
 class VariableMap
 {
 public:
-    class Snapshot
+    /**
+     * @brief The Layout class
+     * Places of values of a variables tree in snapshots, computed once for the tree.
+     * Values of plain types (bool, integers, floating-point numbers, accumulators) are stored at byte offsets
+     * of a single block, strings in a separate list, values of other types (e.g. QColor, QPointF)
+     * in a list of QVariant, groups have no value.
+     */
+    class Layout
     {
-        friend class VariableMap;
+    public:
+        enum class Kind
+        {
+            None,
+            Plain,
+            String,
+            Variant
+        };
 
-        explicit Snapshot(QVariantList data)
+        struct Slot
         {
-            std::swap(m_datas, data);
+            QMetaType type;
+            Kind kind;
+            qsizetype offset;  // in bytes for plain values, index in the list for strings and variants
+            qsizetype size;
+        };
+
+        static constexpr int notFound = -1;
+        static constexpr int ambiguous = -2;
+
+        explicit Layout(const std::vector<IHierarchicalNamedVariable*>& variables)
+        {
+            entries.reserve(variables.size());
+            fullNames.reserve(variables.size());
+            for (const auto& variable : variables)
+            {
+                fullNames.append(variable->fullName());
+                index.insert(fullNames.back(), static_cast<int>(fullNames.size() - 1));
+                const auto type = variable->type();
+                if (!variable->dataPointer())
+                {
+                    entries.append({type, Kind::None, 0, 0});
+                }
+                else if (type == QMetaType::fromType<QString>())
+                {
+                    entries.append({type, Kind::String, strings++, 0});
+                }
+                else if (isPlain(type))
+                {
+                    const auto alignment = static_cast<qsizetype>(type.alignOf());
+                    size = (size + alignment - 1) / alignment * alignment;
+                    entries.append({type, Kind::Plain, size, static_cast<qsizetype>(type.sizeOf())});
+                    size += type.sizeOf();
+                }
+                else
+                {
+                    entries.append({type, Kind::Variant, variants++, 0});
+                }
+            }
+            indexSuffixes();
+        }
+
+        /**
+         * @brief find
+         * @param name full name or its suffix after any ':'
+         * @return position of the variable, notFound or ambiguous if the suffix belongs to many variables
+         */
+        int find(const QString& name) const
+        {
+            return index.value(name, notFound);
+        }
+
+        static bool isPlain(QMetaType type)
+        {
+            switch (type.id())
+            {
+            case QMetaType::Bool:
+            case QMetaType::Char:
+            case QMetaType::SChar:
+            case QMetaType::UChar:
+            case QMetaType::Short:
+            case QMetaType::UShort:
+            case QMetaType::Int:
+            case QMetaType::UInt:
+            case QMetaType::Long:
+            case QMetaType::ULong:
+            case QMetaType::LongLong:
+            case QMetaType::ULongLong:
+            case QMetaType::Double:
+            case QMetaType::Float:
+                return true;
+            default:
+                // accumulators are trivially copyable as well
+                return accumulator::isAccumulator(type);
+            }
         }
 
+    private:
+        void indexSuffixes()
+        {
+            // full names take precedence over suffixes of other names
+            QSet<QString> suffixes;
+            for (int i = 0; i < fullNames.size(); ++i)
+            {
+                const auto& fullName = fullNames[i];
+                for (auto separator = fullName.indexOf(':'); separator != -1; separator = fullName.indexOf(':', separator + 1))
+                {
+                    const auto suffix = fullName.sliced(separator + 1);
+                    auto it = index.find(suffix);
+                    if (it == index.end())
+                    {
+                        index.insert(suffix, i);
+                        suffixes.insert(suffix);
+                    }
+                    else if (it.value() != i && suffixes.contains(suffix))
+                    {
+                        it.value() = ambiguous;
+                    }
+                }
+            }
+        }
+
+    public:
+        QList<Slot> entries;
+        QStringList fullNames;
+        QHash<QString, int> index;  // full names and their suffixes to positions
+        qsizetype size = 0;  // of the block of plain values
+        qsizetype strings = 0;
+        qsizetype variants = 0;
+    };
+
+    /**
+     * @brief The Snapshot class
+     * Values of all variables of a tree, plain values are copied into one flat block
+     * without QVariant, they are decoded only for display (see WatchList)
+     */
+    class Snapshot
+    {
+        friend class VariableMap;
+
     public:
+        Snapshot() = default;
         Snapshot(const Snapshot&) = default;
         Snapshot& operator=(const Snapshot&) = default;
         Snapshot(Snapshot&&) noexcept = default;
         Snapshot& operator=(Snapshot&&) noexcept = default;
 
+        bool matches(const Layout& layout) const
+        {
+            return m_values.size() == layout.size && m_strings.size() == layout.strings && m_variants.size() == layout.variants;
+        }
+
+        friend QDataStream& operator<<(QDataStream& stream, const Snapshot& snapshot)
+        {
+            return stream << snapshot.m_values << snapshot.m_strings << snapshot.m_variants;
+        }
+        friend QDataStream& operator>>(QDataStream& stream, Snapshot& snapshot)
+        {
+            return stream >> snapshot.m_values >> snapshot.m_strings >> snapshot.m_variants;
+        }
+
     private:
-        QVariantList m_datas;
+        QByteArray m_values;
+        QStringList m_strings;
+        QVariantList m_variants;
     };
 
-    class WatchList
+    /**
+     * @brief The Handle class
+     * Typed access to a variable resolved once, e.g. in setup(),
+     * instead of looking it up by name in every run()
+     */
+    template <typename T>
+    class Handle
     {
         friend class VariableMap;
 
-        WatchList(const std::vector<IHierarchicalNamedVariable*>& variables)
-        {
-            m_datas.reserve(variables.size());
-            m_fullNames.reserve(variables.size());
-            for (int i = 0; i < variables.size(); ++i)
-            {
-                m_datas.append(variables[i]->get());
-                m_fullNames.append(variables[i]->fullName());
-            }
-        }
+        Handle(T* data, int index)
+            : m_data{data}
+            , m_index{index}
+        {}
 
     public:
-        WatchList(const WatchList& watchlist)
-            : m_datas{watchlist.m_datas}
-            , m_fullNames{watchlist.m_fullNames}
+        Handle() = default;
+
+        T& operator*() const { return *m_data; }
+        T* operator->() const { return m_data; }
+        T* get() const { return m_data; }
+        explicit operator bool() const { return m_data != nullptr; }
+
+        /**
+         * @brief index
+         * @return position of the variable in the VariableMap and in its snapshots
+         */
+        int index() const { return m_index; }
+
+    private:
+        T* m_data = nullptr;
+        int m_index = -1;
+    };
+
+    class WatchList
+    {
+        friend class VariableMap;
+
+        WatchList(std::shared_ptr<const Layout> layout, Snapshot snapshot)
+            : m_layout{std::move(layout)}
+            , m_snapshot{std::move(snapshot)}
         {}
-        WatchList& operator=(const WatchList& watchlist)
-        {
-            m_datas = watchlist.m_datas;
-            m_fullNames = watchlist.m_fullNames;
-            return *this;
-        }
-        WatchList(WatchList&& watchlist)
-        {
-            std::swap(m_datas, watchlist.m_datas);
-            std::swap(m_fullNames, watchlist.m_fullNames);
-        }
-        WatchList& operator=(WatchList&& watchlist)
-        {
-            std::swap(m_datas, watchlist.m_datas);
-            std::swap(m_fullNames, watchlist.m_fullNames);
-            return *this;
-        }
-        void update(Snapshot snapshot)
+
+    public:
+        WatchList(const WatchList& watchlist) = default;
+        WatchList& operator=(const WatchList& watchlist) = default;
+        WatchList(WatchList&& watchlist) noexcept = default;
+        WatchList& operator=(WatchList&& watchlist) noexcept = default;
+
+        /**
+         * @brief update
+         * Replaces watched values with the snapshot
+         * @return positions of variables whose values differ from the previous ones
+         */
+        QList<int> update(Snapshot snapshot)
         {
-            std::swap(snapshot.m_datas, m_datas);
+            if (!snapshot.matches(*m_layout))
+                throw std::runtime_error{"Snapshot does not match variables on the watch list"};
+            std::swap(snapshot, m_snapshot);
+            return changedSince(snapshot);
         }
-        void update(const QVariantMap& map)
+        QList<int> update(const QVariantMap& map)
         {
+            QList<int> changed;
             for (const auto& [name, value] : map.asKeyValueRange())
             {
-                if (auto pos = find(name); pos != -1)
+                if (auto pos = find(name); pos != -1 && encode(pos, value))
                 {
-                    m_datas[pos] = value;
+                    changed.append(pos);
                 }
             }
+            return changed;
         }
         std::size_t size() const
         {
-            return m_datas.size();
+            return m_layout->entries.size();
         }
         bool contains(const QString& name) const
         {
@@ -330,45 +549,133 @@ public:
         }
         bool contains(const int& id) const
         {
-            return (id < m_datas.size());
+            return (id < m_layout->entries.size());
         }
         template <typename T>
         T get(const QString& name) const
         {
-            return operator[](name).value<T>();
+            if (auto pos = find(name); pos != -1)
+                return value<T>(pos);
+            throw std::runtime_error{std::format("Variable (name: {}) not on the watch list.\n{}", name.toStdString(), validate(name).toStdString())};
         }
         template <typename T>
         T get(const int& id) const
         {
-            return operator[](id).value<T>();
+            if (id < m_layout->entries.size())
+                return value<T>(id);
+            throw std::runtime_error{std::format("Variable (id: {}) not on the watch list, there is {} elements on list", id, m_layout->entries.size())};
         }
         QVariant operator[](const QString& name) const
         {
             if (auto pos = find(name); pos != -1)
-                return m_datas[pos];
+                return decode(pos);
             throw std::runtime_error{std::format("Variable (name: {}) not on the watch list.\n{}", name.toStdString(), validate(name).toStdString())};
         }
         QVariant operator[](const int& id) const
         {
-            if (id < m_datas.size())
-                return m_datas[id];
-            throw std::runtime_error{std::format("Variable (id: {}) not on the watch list, there is {} elements on list", id, m_datas.size())};
+            if (id < m_layout->entries.size())
+                return decode(id);
+            throw std::runtime_error{std::format("Variable (id: {}) not on the watch list, there is {} elements on list", id, m_layout->entries.size())};
         }
     private:
-        int find(const QString& name) const
+        template <typename T>
+        T value(int pos) const
         {
-            auto lastSubname = ':' + name;
-            for (int i = 0; i < m_fullNames.size(); ++i)
+            // the value of the same type is read directly from the snapshot, others are converted
+            const auto& slot = m_layout->entries[pos];
+            if (slot.type == QMetaType::fromType<T>())
             {
-                if (m_fullNames[i] == name || m_fullNames[i].endsWith(lastSubname))
+                if constexpr (std::is_same_v<T, QString>)
+                {
+                    return m_snapshot.m_strings[slot.offset];
+                }
+                else if constexpr (std::is_trivially_copyable_v<T>)
                 {
-                    return i;
+                    if (slot.kind == Layout::Kind::Plain)
+                    {
+                        T result;
+                        std::memcpy(&result, m_snapshot.m_values.constData() + slot.offset, sizeof(T));
+                        return result;
+                    }
                 }
             }
-            return -1;
+            return decode(pos).value<T>();
+        }
+        QVariant decode(int pos) const
+        {
+            const auto& slot = m_layout->entries[pos];
+            switch (slot.kind)
+            {
+            case Layout::Kind::Plain:
+                return QVariant(slot.type, m_snapshot.m_values.constData() + slot.offset);
+            case Layout::Kind::String:
+                return QVariant(m_snapshot.m_strings[slot.offset]);
+            case Layout::Kind::Variant:
+                return m_snapshot.m_variants[slot.offset];
+            default:
+                return QVariant{};
+            }
+        }
+        bool encode(int pos, const QVariant& value)
+        {
+            const auto& slot = m_layout->entries[pos];
+            if (slot.kind == Layout::Kind::String)
+            {
+                auto string = value.toString();
+                if (m_snapshot.m_strings[slot.offset] == string)
+                    return false;
+                m_snapshot.m_strings[slot.offset] = std::move(string);
+                return true;
+            }
+            else if (slot.kind == Layout::Kind::Plain)
+            {
+                auto converted = value;
+                auto* data = m_snapshot.m_values.data() + slot.offset;
+                if (!converted.convert(slot.type) || std::memcmp(data, converted.constData(), slot.size) == 0)
+                    return false;
+                std::memcpy(data, converted.constData(), slot.size);
+                return true;
+            }
+            else if (slot.kind == Layout::Kind::Variant)
+            {
+                auto converted = value;
+                auto& stored = m_snapshot.m_variants[slot.offset];
+                if (!converted.convert(slot.type) || converted == stored)
+                    return false;
+                stored = std::move(converted);
+                return true;
+            }
+            return false;
+        }
+        QList<int> changedSince(const Snapshot& previous) const
+        {
+            // values are compared bytewise, so a variable is dirty only when its stored value moved
+            QList<int> changed;
+            const auto* values = m_snapshot.m_values.constData();
+            const auto* previousValues = previous.m_values.constData();
+            for (int pos = 0; pos < m_layout->entries.size(); ++pos)
+            {
+                const auto& slot = m_layout->entries[pos];
+                if ((slot.kind == Layout::Kind::Plain
+                     && std::memcmp(values + slot.offset, previousValues + slot.offset, slot.size) != 0)
+                    || (slot.kind == Layout::Kind::String
+                        && m_snapshot.m_strings[slot.offset] != previous.m_strings[slot.offset])
+                    || (slot.kind == Layout::Kind::Variant
+                        && m_snapshot.m_variants[slot.offset] != previous.m_variants[slot.offset]))
+                {
+                    changed.append(pos);
+                }
+            }
+            return changed;
+        }
+        int find(const QString& name) const
+        {
+            return std::max(m_layout->find(name), -1);
         }
         QString validate(const QString& name) const
         {
+            if (m_layout->find(name) == Layout::ambiguous)
+                return QString("Name '%1' matches many variables, use the full name").arg(name);
             if (name == ":")
                 return QString("Invalid name ':'");
             if (!name.isEmpty() && name.back() == ':')
@@ -379,8 +686,8 @@ public:
             return QString("No variable with the specified name was found");
         }
     private:
-        QVariantList m_datas;
-        QStringList m_fullNames;
+        std::shared_ptr<const Layout> m_layout;
+        Snapshot m_snapshot;
     };
 
 public:
@@ -391,16 +698,16 @@ public:
     VariableMap(VariableMap&& vm)
     {
         std::swap(m_variables, vm.m_variables);
-        std::swap(m_mapByNames, vm.m_mapByNames);
+        std::swap(m_layout, vm.m_layout);
         vm.m_variables.clear();
-        vm.m_mapByNames.clear();
+        vm.m_layout.reset();
     }
     VariableMap& operator=(VariableMap&& vm)
     {
         std::swap(m_variables, vm.m_variables);
-        std::swap(m_mapByNames, vm.m_mapByNames);
+        std::swap(m_layout, vm.m_layout);
         vm.m_variables.clear();
-        vm.m_mapByNames.clear();
+        vm.m_layout.reset();
         return *this;
     }
 
@@ -413,9 +720,9 @@ public:
         }
         const auto takeAll = [](const auto&) { return true; };
         m_variables.clear();
-        m_mapByNames.clear();
         root->preorderTraversalSquash(m_variables, takeAll);
-        fillTheMap();
+        checkIds();
+        m_layout = std::make_shared<const Layout>(m_variables);
     }
 
     template <typename T>
@@ -430,6 +737,18 @@ public:
         return *reinterpret_cast<T*>(variable->dataPointer());
     }
 
+    /**
+     * @brief handle
+     * Resolves the variable once, see Handle
+     * @throws std::runtime_error if the variable does not exist or has a different type
+     */
+    template <typename T>
+    Handle<T> handle(const QString& name)
+    {
+        auto& value = ref<T>(name);
+        return Handle<T>{&value, named(name)->id()};
+    }
+
     void reset()
     {
         for (auto& var : m_variables)
@@ -438,6 +757,28 @@ public:
         }
     }
 
+    /**
+     * @brief restore
+     * Sets values of all variables from the snapshot of the same variables tree
+     */
+    void restore(const Snapshot& snapshot)
+    {
+        if (!m_layout || !snapshot.matches(*m_layout))
+            throw std::runtime_error{std::format("Snapshot of {} bytes, {} strings and {} variants cannot be restored in VariableMap of {} variables",
+                                                 snapshot.m_values.size(), snapshot.m_strings.size(), snapshot.m_variants.size(), m_variables.size())};
+        for (std::size_t i = 0; i < m_variables.size(); ++i)
+        {
+            // groups have no value of their own
+            const auto& slot = m_layout->entries[i];
+            if (slot.kind == Layout::Kind::Plain)
+                std::memcpy(m_variables[i]->dataPointer(), snapshot.m_values.constData() + slot.offset, slot.size);
+            else if (slot.kind == Layout::Kind::String)
+                *static_cast<QString*>(m_variables[i]->dataPointer()) = snapshot.m_strings[slot.offset];
+            else if (slot.kind == Layout::Kind::Variant)
+                m_variables[i]->set(snapshot.m_variants[slot.offset]);
+        }
+    }
+
     std::size_t size() const
     {
         return m_variables.size();
@@ -445,17 +786,11 @@ public:
 
     IHierarchicalNamedVariable* named(const QString& name)
     {
-        auto it = m_mapByNames.find(name);
-        if (it != m_mapByNames.end())
-            return it.value();
-        auto lastSubname = ':' + name;
-        for (const auto& [varName, var] : m_mapByNames.asKeyValueRange())
-        {
-            if (varName.endsWith(lastSubname))
-            {
-                return var;
-            }
-        }
+        const auto pos = m_layout ? m_layout->find(name) : Layout::notFound;
+        if (pos >= 0)
+            return m_variables[pos];
+        if (pos == Layout::ambiguous)
+            throw std::runtime_error{std::format("Object (name: {}) is ambiguous in VariableMap, use the full name", name.toStdString())};
         throw std::runtime_error{std::format("Object (name: {}) not exists in VariableMap", name.toStdString())};
     }
 
@@ -474,35 +809,46 @@ public:
 
     inline Snapshot snapshot() const
     {
-        auto result = QVariantList{};
-        result.reserve(m_variables.size());
-        for (const auto& variable : m_variables)
+        // one block for all plain values, filled without QVariant
+        auto result = Snapshot{};
+        if (!m_layout)
+            return result;
+        result.m_values = QByteArray(m_layout->size, '\0');
+        result.m_strings.resize(m_layout->strings);
+        result.m_variants.resize(m_layout->variants);
+        auto* values = result.m_values.data();
+        for (std::size_t i = 0; i < m_variables.size(); ++i)
         {
-            result.push_back(variable->get());
+            const auto& slot = m_layout->entries[i];
+            if (slot.kind == Layout::Kind::Plain)
+                std::memcpy(values + slot.offset, m_variables[i]->dataPointer(), slot.size);
+            else if (slot.kind == Layout::Kind::String)
+                result.m_strings[slot.offset] = *static_cast<const QString*>(m_variables[i]->dataPointer());
+            else if (slot.kind == Layout::Kind::Variant)
+                result.m_variants[slot.offset] = QVariant(slot.type, m_variables[i]->dataPointer());
         }
-        return Snapshot{std::move(result)};
+        return result;
     }
 
     inline WatchList watch() const
     {
-        return WatchList{m_variables};
+        return WatchList{m_layout ? m_layout : std::make_shared<const Layout>(m_variables), snapshot()};
     }
 
 private:
-    void fillTheMap()
+    void checkIds()
     {
         for (int i = 0; i < m_variables.size(); ++i)
         {
             const auto& var = m_variables[i];
-            m_mapByNames[var->fullName()] = var;
-            Q_ASSERT_X(i == var->id(), "api::VariableMap::fillTheMap()",
+            Q_ASSERT_X(i == var->id(), "api::VariableMap::checkIds()",
                        "Variable position after tree squash MUST correspond to variable id()");
         }
     }
 
 private:
     std::vector<IHierarchicalNamedVariable*> m_variables;
-    QMap<QString, IHierarchicalNamedVariable*> m_mapByNames;
+    std::shared_ptr<const Layout> m_layout;
 };
 
 }  // namespace api::common
@@ -587,5 +933,6 @@ using VariableGroup = ::api::common::VariableGroup;
 using VariableMap = ::api::common::VariableMap;
 using VariableWatchList = ::api::common::VariableMap::WatchList;
 using VariableMapSnapshot = ::api::common::VariableMap::Snapshot;
+template <typename T> using StatHandle = ::api::common::VariableMap::Handle<T>;
 
 }  // namespace api
@@ -0,0 +1,119 @@
+/**
+ * Cost of a single random number drawn by the engines of NumberGeneratorFactory.
+ * Every engine is measured through the virtual real() path, the inlined uniform() fast path
+ * and the bulk fill(), numbers are drawn in iterations of drawsPerIteration numbers as in run().
+ * The entropy source read for every number (random seeds before they were drawn once)
+ * and the seeded RandomNumberGenerator used for seed 0 are measured for comparison.
+ *
+ * Usage: simulit-benchmarks [draws], 10'000'000 draws by default
+ */
+
+#include <QTextStream>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "tools/numbergeneratorfactory.hpp"
+#include "tools/randomnumbergenerator.hpp"
+
+
+namespace
+{
+
+constexpr int drawsPerIteration = 16;
+
+// sum of all numbers is printed, so the compiler cannot skip the draws
+double sink = 0.0;
+
+template <typename Draw>
+double nanosecondsPerDraw(qint64 draws, Draw&& draw)
+{
+    const auto start = std::chrono::steady_clock::now();
+    draw(draws);
+    const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    return elapsed.count() / static_cast<double>(draws);
+}
+
+double measureReal(api::NumberGenerator& generator, qint64 draws)
+{
+    return nanosecondsPerDraw(draws, [&generator](qint64 draws) {
+        for (qint64 iteration = 0; iteration < draws / drawsPerIteration; ++iteration)
+        {
+            generator.beginIteration(iteration);
+            for (int i = 0; i < drawsPerIteration; ++i)
+                sink += generator.real(0.0, 1.0);
+        }
+    });
+}
+
+double measureUniform(api::NumberGenerator& generator, qint64 draws)
+{
+    return nanosecondsPerDraw(draws, [&generator](qint64 draws) {
+        for (qint64 iteration = 0; iteration < draws / drawsPerIteration; ++iteration)
+        {
+            generator.beginIteration(iteration);
+            for (int i = 0; i < drawsPerIteration; ++i)
+                sink += generator.uniform();
+        }
+    });
+}
+
+double measureFill(api::NumberGenerator& generator, qint64 draws)
+{
+    auto values = std::vector<double>(drawsPerIteration);
+    return nanosecondsPerDraw(draws, [&generator, &values](qint64 draws) {
+        for (qint64 iteration = 0; iteration < draws / drawsPerIteration; ++iteration)
+        {
+            generator.beginIteration(iteration);
+            generator.fill(values, 0.0, 1.0);
+            for (auto value : values)
+                sink += value;
+        }
+    });
+}
+
+}  // namespace
+
+
+int main(int argc, char* argv[])
+{
+    const qint64 draws = argc > 1 ? std::max(QString(argv[1]).toLongLong(), qint64{drawsPerIteration}) : 10'000'000;
+    QTextStream out(stdout);
+    out << QString("%1 %2 %3 %4\n").arg("engine", -16).arg("real() ns", 12).arg("uniform() ns", 14).arg("fill() ns", 12);
+
+    // the entropy source is orders of magnitude slower, a small part of draws is enough
+    {
+        std::random_device device;
+        auto distribution = std::uniform_real_distribution<double>(0.0, 1.0);
+        const auto cost = nanosecondsPerDraw(std::max(draws / 100, qint64{1}), [&device, &distribution](qint64 draws) {
+            for (qint64 i = 0; i < draws; ++i)
+                sink += distribution(device);
+        });
+        out << QString("%1 %2\n").arg("random_device", -16).arg(cost, 12, 'f', 2);
+    }
+    {
+        auto generator = api::RandomNumberGenerator();
+        out << QString("%1 %2 %3 %4\n").arg("seed 0", -16)
+                   .arg(measureReal(generator, draws), 12, 'f', 2)
+                   .arg(measureUniform(generator, draws), 14, 'f', 2)
+                   .arg(measureFill(generator, draws), 12, 'f', 2);
+    }
+
+    for (const auto& name : tools::NumberGeneratorFactory::engineNames())
+    {
+        const auto engine = *tools::NumberGeneratorFactory::engine(name);
+        const auto create = [engine]() {
+            return std::unique_ptr<api::NumberGenerator>(tools::NumberGeneratorFactory().create(1, 0, engine));
+        };
+        // fresh generators, so that every path starts with an empty buffer
+        const auto real = measureReal(*create(), draws);
+        const auto uniform = measureUniform(*create(), draws);
+        const auto fill = measureFill(*create(), draws);
+        out << QString("%1 %2 %3 %4\n").arg(name, -16).arg(real, 12, 'f', 2).arg(uniform, 14, 'f', 2).arg(fill, 12, 'f', 2);
+    }
+
+    out << QString("checksum %1\n").arg(sink);
+    return 0;
+}
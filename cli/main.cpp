@@ -0,0 +1,360 @@
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <memory>
+
+#include "api/simulation.hpp"
+#include "loaders/dllloader.hpp"
+#include "runners/headlessrunner.hpp"
+#include "sweep/sweeprunner.hpp"
+
+
+/**
+ * Command line runner of simulation plugins, nothing is displayed.
+ * Run configuration may be given as JSON file, e.g.
+ *      {
+ *          "simulation": "Za wcześnie czy za późno?",
+ *          "iterations": 1000000,
+ *          "seed": 42,
+ *          "threads": 8,
+ *          "generator": "philox",
+ *          "properties": { "Animowanie": false },
+ *          "sweep": {
+ *              "design": "grid",
+ *              "axes": [
+ *                  { "name": "Autobus:Najwcześniej", "values": ["7:50", "7:55", "7:58"] },
+ *                  { "name": "Chłopiec:Najpóźniej", "values": ["8:00", "8:05"] }
+ *              ]
+ *          }
+ *      }
+ * command line options override values from the file.
+ * With sweep axes every combination of properties is evaluated and results are printed as a table.
+ */
+
+namespace
+{
+QTextStream& out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QTextStream& err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+QJsonObject readConfiguration(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        throw std::runtime_error{QString("Cannot open configuration file '%1'").arg(path).toStdString()};
+    QJsonParseError parseError;
+    const auto document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject())
+        throw std::runtime_error{QString("Invalid configuration file '%1': %2").arg(path, parseError.errorString()).toStdString()};
+    return document.object();
+}
+
+void setProperty(api::Variables properties, const QString& name, const QVariant& value)
+{
+    auto variable = api::VariableMap(properties).named(name);
+    if (!variable->set(value))
+        throw std::runtime_error{QString("Invalid value '%1' of property '%2'").arg(value.toString(), name).toStdString()};
+}
+
+void listVariables(api::Variables variables, const QString& indent)
+{
+    auto variableMap = api::VariableMap(variables);
+    for (int i = 0; i < static_cast<int>(variableMap.size()); ++i)
+    {
+        auto variable = dynamic_cast<api::IVariable*>(variableMap.number(i));
+        if (variable && !variable->name().isEmpty() && variable->dataPointer())
+            out() << indent << runners::HeadlessRunner::displayName(*variable)
+                  << " [" << variable->type().name() << "] = " << variable->get().toString() << "\n";
+    }
+}
+
+void list(const QObjectList& plugins)
+{
+    for (const auto& plugin : plugins)
+    {
+        auto simulation = qobject_cast<api::ISimulationDLL*>(plugin);
+        out() << simulation->name() << "\n";
+        out() << "  properties:\n";
+        listVariables(simulation->properties(), "    ");
+        out() << "  statistics:\n";
+        listVariables(simulation->statistics(), "    ");
+    }
+}
+
+api::ISimulationDLL* find(const QObjectList& plugins, const QString& name)
+{
+    for (const auto& plugin : plugins)
+    {
+        auto simulation = qobject_cast<api::ISimulationDLL*>(plugin);
+        if (simulation && simulation->name() == name)
+            return simulation;
+    }
+    throw std::runtime_error{QString("Simulation '%1' not found, use --list to see available simulations").arg(name).toStdString()};
+}
+
+int toInt(const QString& value, const QString& option)
+{
+    bool ok = false;
+    const auto result = value.toInt(&ok);
+    if (!ok)
+        throw std::runtime_error{QString("Invalid value '%1' of option --%2").arg(value, option).toStdString()};
+    return result;
+}
+
+qint64 toInt64(const QString& value, const QString& option)
+{
+    bool ok = false;
+    const auto result = value.toLongLong(&ok);
+    if (!ok)
+        throw std::runtime_error{QString("Invalid value '%1' of option --%2").arg(value, option).toStdString()};
+    return result;
+}
+
+// "name=from..to/steps" is a range, "name=a,b,c" is a list of values
+sweep::Axis parseAxis(const QString& specification)
+{
+    const auto separator = specification.indexOf('=');
+    if (separator <= 0)
+        throw std::runtime_error{QString("Invalid sweep axis '%1', expected name=from..to/steps or name=a,b,c").arg(specification).toStdString()};
+    const auto name = specification.left(separator);
+    const auto values = specification.mid(separator + 1);
+
+    static const auto rangePattern = QRegularExpression(R"(^\s*([-+0-9.eE]+)\s*\.\.\s*([-+0-9.eE]+)\s*(?:/\s*(\d+))?\s*$)");
+    if (const auto match = rangePattern.match(values); match.hasMatch())
+    {
+        bool fromOk = false, toOk = false;
+        const auto from = match.captured(1).toDouble(&fromOk);
+        const auto to = match.captured(2).toDouble(&toOk);
+        const auto steps = match.captured(3).isEmpty() ? 2 : match.captured(3).toInt();
+        if (fromOk && toOk && steps > 0)
+            return sweep::Axis::range(name, from, to, steps);
+    }
+    auto list = QVariantList{};
+    for (const auto& value : values.split(','))
+    {
+        list.append(value.trimmed());
+    }
+    return sweep::Axis::list(name, list);
+}
+
+sweep::Axis parseAxis(const QJsonObject& json)
+{
+    const auto name = json.value("name").toString();
+    if (name.isEmpty())
+        throw std::runtime_error{"Sweep axis without a name"};
+    if (json.contains("values"))
+        return sweep::Axis::list(name, json.value("values").toArray().toVariantList());
+    return sweep::Axis::range(name, json.value("from").toDouble(), json.value("to").toDouble(), json.value("steps").toInt(2));
+}
+
+sweep::Design parseDesign(const QString& design)
+{
+    if (design.isEmpty() || design == "grid")
+        return sweep::Design::Grid;
+    if (design == "lhs")
+        return sweep::Design::LatinHypercube;
+    throw std::runtime_error{QString("Unknown sweep design '%1', expected grid or lhs").arg(design).toStdString()};
+}
+
+QJsonObject toJson(const QString& simulation, const runners::HeadlessRunner::Result& result)
+{
+    QJsonObject statistics;
+    for (const auto& [name, value] : result.statistics)
+    {
+        statistics.insert(name, QJsonValue::fromVariant(value));
+    }
+    QJsonObject json;
+    json.insert("simulation", simulation);
+    json.insert("iterations", result.iterations);
+    json.insert("threads", result.threads);
+    json.insert("seed", result.seed);
+    json.insert("seconds", result.seconds);
+    json.insert("iterationsPerSecond", result.seconds > 0.0 ? static_cast<double>(result.iterations) / result.seconds : 0.0);
+    json.insert("statistics", statistics);
+    if (!result.error.isEmpty())
+        json.insert("error", result.error);
+    return json;
+}
+
+QJsonObject toJson(const QString& simulation, const sweep::Table& table)
+{
+    QJsonArray rows;
+    for (const auto& row : table.rows)
+    {
+        auto json = toJson(simulation, row.result);
+        json.remove("simulation");
+        QJsonObject parameters;
+        for (int i = 0; i < table.parameters.size(); ++i)
+        {
+            parameters.insert(table.parameters[i], QJsonValue::fromVariant(row.parameters[i]));
+        }
+        json.insert("parameters", parameters);
+        rows.append(json);
+    }
+    QJsonObject json;
+    json.insert("simulation", simulation);
+    json.insert("rows", rows);
+    return json;
+}
+
+void write(const QString& path, const QByteArray& content)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        throw std::runtime_error{QString("Cannot write results to '%1'").arg(path).toStdString()};
+    file.write(content);
+}
+}  // namespace
+
+
+int main(int argc, char *argv[])
+{
+    // nothing is displayed, but animated simulations still draw with QtGui
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+    QCoreApplication::setApplicationName("appsimulit-cli");
+    // accumulator statistics are printed and exported as text
+    api::accumulator::registerConverters();
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs simulation plugins without the user interface.");
+    parser.addHelpOption();
+    const QCommandLineOption listOption("list", "List available simulations with their properties and statistics.");
+    const QCommandLineOption pluginsOption("plugins", "Directory with simulation plugins.", "directory", "simulations");
+    const QCommandLineOption configOption({"c", "config"}, "JSON file with the run configuration.", "file");
+    const QCommandLineOption simulationOption({"s", "simulation"}, "Name of the simulation to run.", "name");
+    const QCommandLineOption setOption("set", "Set a simulation property, e.g. --set \"Autobus:Najwcześniej=7:50\".", "name=value");
+    const QCommandLineOption iterationsOption({"n", "iterations"}, "Number of iterations.", "count");
+    const QCommandLineOption seedOption("seed", "Random seed, 0 for a random seed (the seed used is printed).", "seed");
+    const QCommandLineOption threadsOption({"t", "threads"}, "Number of simulation instances run in parallel.", "count");
+    const QCommandLineOption generatorOption("generator", "Random number engine: mt19937, philox, xoshiro256**, pcg64, splitmix64, sobol or halton. Numbers of iterations of philox, sobol and halton do not depend on the number of threads, integer statistics are reproduced exactly, floating-point ones up to rounding.", "name");
+    const QCommandLineOption outputOption({"o", "output"}, "Write results to the JSON file.", "file");
+    const QCommandLineOption sweepOption("sweep", "Sweep a property over a range or a list, e.g. --sweep \"Ratio=0.1..0.9/5\" or --sweep \"Autobus:Najwcześniej=7:50,7:55\".", "name=values");
+    const QCommandLineOption samplesOption("lhs", "Use Latin hypercube design with the number of samples instead of the grid.", "samples");
+    const QCommandLineOption concurrencyOption("concurrency", "Number of configurations evaluated at the same time, all cores by default.", "count");
+    const QCommandLineOption tableOption("table", "Write sweep results to the CSV file.", "file");
+    parser.addOptions({listOption, pluginsOption, configOption, simulationOption, setOption,
+                       iterationsOption, seedOption, threadsOption, generatorOption, outputOption,
+                       sweepOption, samplesOption, concurrencyOption, tableOption});
+    parser.process(app);
+
+    try
+    {
+        auto plugins = loaders::DllLoader(&app).load(QDir(parser.value(pluginsOption)));
+        if (parser.isSet(listOption))
+        {
+            list(plugins);
+            return 0;
+        }
+
+        auto configuration = parser.isSet(configOption) ? readConfiguration(parser.value(configOption)) : QJsonObject{};
+        auto name = parser.isSet(simulationOption) ? parser.value(simulationOption) : configuration.value("simulation").toString();
+        if (name.isEmpty())
+            throw std::runtime_error{"No simulation selected, use --simulation or --config"};
+        auto plugin = find(plugins, name);
+
+        auto options = runners::HeadlessRunner::Options{};
+        options.iterations = configuration.value("iterations").toInteger(options.iterations);
+        options.seed = configuration.value("seed").toInt(options.seed);
+        options.threads = configuration.value("threads").toInt(options.threads);
+        if (parser.isSet(iterationsOption))
+            options.iterations = toInt64(parser.value(iterationsOption), "iterations");
+        if (parser.isSet(seedOption))
+            options.seed = toInt(parser.value(seedOption), "seed");
+        if (parser.isSet(threadsOption))
+            options.threads = toInt(parser.value(threadsOption), "threads");
+        const auto generator = parser.isSet(generatorOption) ? parser.value(generatorOption) : configuration.value("generator").toString("mt19937");
+        if (auto engine = tools::NumberGeneratorFactory::engine(generator))
+            options.engine = *engine;
+        else
+            throw std::runtime_error{QString("Unknown random number engine '%1', expected one of: %2").arg(generator, tools::NumberGeneratorFactory::engineNames().join(", ")).toStdString()};
+        if (options.iterations <= 0)
+            throw std::runtime_error{"Number of iterations must be positive"};
+
+        auto properties = std::unique_ptr<api::IVariable>(plugin->properties()->clone());
+        const auto configuredProperties = configuration.value("properties").toObject();
+        for (auto it = configuredProperties.begin(); it != configuredProperties.end(); ++it)
+        {
+            setProperty(properties.get(), it.key(), it.value().toVariant());
+        }
+        for (const auto& assignment : parser.values(setOption))
+        {
+            const auto separator = assignment.indexOf('=');
+            if (separator <= 0)
+                throw std::runtime_error{QString("Invalid property assignment '%1', expected name=value").arg(assignment).toStdString()};
+            setProperty(properties.get(), assignment.left(separator), assignment.mid(separator + 1));
+        }
+
+        auto plan = sweep::Plan{};
+        const auto configuredSweep = configuration.value("sweep").toObject();
+        plan.design = parseDesign(configuredSweep.value("design").toString());
+        plan.samples = configuredSweep.value("samples").toInt(plan.samples);
+        for (const auto& axis : configuredSweep.value("axes").toArray())
+        {
+            plan.axes.append(parseAxis(axis.toObject()));
+        }
+        for (const auto& axis : parser.values(sweepOption))
+        {
+            plan.axes.append(parseAxis(axis));
+        }
+        if (parser.isSet(samplesOption))
+        {
+            plan.design = sweep::Design::LatinHypercube;
+            plan.samples = toInt(parser.value(samplesOption), "lhs");
+        }
+        plan.seed = options.seed;
+
+        if (!plan.axes.isEmpty())
+        {
+            auto sweepOptions = sweep::SweepRunner::Options{};
+            sweepOptions.run = options;
+            sweepOptions.concurrency = configuredSweep.value("concurrency").toInt(0);
+            if (parser.isSet(concurrencyOption))
+                sweepOptions.concurrency = toInt(parser.value(concurrencyOption), "concurrency");
+
+            const auto table = sweep::SweepRunner(plugin).run(plan, properties.get(), sweepOptions);
+            out() << table.toCsv('\t');
+            if (parser.isSet(tableOption))
+                write(parser.value(tableOption), table.toCsv().toUtf8());
+            if (parser.isSet(outputOption))
+                write(parser.value(outputOption), QJsonDocument(toJson(plugin->name(), table)).toJson());
+            return 0;
+        }
+
+        auto result = runners::HeadlessRunner(plugin).run(properties.get(), options);
+        if (!result.error.isEmpty())
+            throw std::runtime_error{result.error.toStdString()};
+
+        out() << plugin->name() << "\n";
+        out() << "iterations: " << result.iterations << ", threads: " << result.threads
+              << ", seed: " << result.seed << ", time: " << result.seconds << " s, iterations/s: "
+              << (result.seconds > 0.0 ? static_cast<double>(result.iterations) / result.seconds : 0.0) << "\n";
+        for (const auto& [statistic, value] : result.statistics)
+        {
+            out() << statistic << ": " << value.toString() << "\n";
+        }
+
+        if (parser.isSet(outputOption))
+            write(parser.value(outputOption), QJsonDocument(toJson(plugin->name(), result)).toJson());
+    }
+    catch (std::exception& e)
+    {
+        err() << "Error: " << QString::fromStdString(e.what()) << "\n";
+        return 1;
+    }
+    return 0;
+}
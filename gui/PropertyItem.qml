@@ -6,7 +6,7 @@ Item {
     id: root
 
     property string label: ""
-    property string type: "text"     // "text" | "int" | "double" | "bool"
+    property string type: "text"     // "text" | "int" | "int64" | "uint64" | "double" | "bool"
     property var value: null
     property string hint: ""
 
@@ -42,6 +42,8 @@ Item {
             sourceComponent: {
                 switch (root.type) {
                 case "int":    return intEditor;
+                case "int64":  return intEditor;
+                case "uint64": return intEditor;
                 case "double": return doubleEditor;
                 case "bool":   return boolEditor;
                 default:       return textEditor;
@@ -64,11 +66,12 @@ Item {
         }
     }
 
-    // int
+    // int, also 64-bit, the text is converted on the C++ side without loss of precision
     Component {
         id: intEditor
         TextField {
             text: prop.value === null ? "" : String(prop.value)
+            validator: RegularExpressionValidator { regularExpression: root.type === "uint64" ? /\d+/ : /-?\d+/ }
             onEditingFinished: {
                 prop.value = text;
             }
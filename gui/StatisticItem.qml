@@ -7,8 +7,8 @@ Item {
 
     property var stat: null
 
-    implicitHeight: row.implicitHeight
-    implicitWidth: row.implicitWidth
+    implicitHeight: column.implicitHeight
+    implicitWidth: column.implicitWidth
 
     HoverHandler {
         id: hover
@@ -19,38 +19,101 @@ Item {
     ToolTip.visible: hovered && stat?.hint !== ""
     ToolTip.text: stat?.hint ?? ""
 
-    RowLayout {
-        id: row
+    ColumnLayout {
+        id: column
         anchors.fill: parent
-        spacing: 4
+        spacing: 2
 
-        Label {
-            id: labelItem
-            font.family: "Source Sans 3"
-            font.pixelSize: 12
-            font.bold: true
+        RowLayout {
+            id: row
+            Layout.fillWidth: true
+            spacing: 4
 
-            Layout.preferredWidth: 90
-            Layout.minimumWidth: 90
-            Layout.maximumWidth: 90
+            Label {
+                id: labelItem
+                font.family: "Source Sans 3"
+                font.pixelSize: 12
+                font.bold: true
 
-            wrapMode: Text.Wrap
-            horizontalAlignment: Text.AlignHCenter
-            verticalAlignment: Text.AlignVCenter
-            textFormat: Text.PlainText
+                Layout.preferredWidth: 90
+                Layout.minimumWidth: 90
+                Layout.maximumWidth: 90
 
-            text: stat?.label ?? ""
+                wrapMode: Text.Wrap
+                horizontalAlignment: Text.AlignHCenter
+                verticalAlignment: Text.AlignVCenter
+                textFormat: Text.PlainText
+
+                text: stat?.label ?? ""
+            }
+
+            Label {
+                id: valueItem
+                font.family: "Source Sans 3"
+                font.pixelSize: 11
+
+                Layout.alignment: Qt.AlignRight
+                // accumulators have the standard error, shown as value ± error
+                readonly property string valueText: typeof stat?.value === "number" && Math.floor(stat.value) !== stat.value
+                                                    ? stat.value.toFixed(3)
+                                                    : (stat?.value ?? "")
+                text: typeof stat?.error === "number"
+                      ? valueText + " \u00B1 " + stat.error.toFixed(3)
+                      : valueText
+            }
         }
 
-        Label {
-            id: valueItem
-            font.family: "Source Sans 3"
-            font.pixelSize: 11
+        // histograms are drawn as a bar chart of their bins
+        Item {
+            id: chart
+            readonly property var histogram: stat?.histogram
+            readonly property real maximum: histogram ? Math.max(1, ...histogram.counts) : 1
+
+            visible: histogram !== undefined && histogram !== null
+            Layout.fillWidth: true
+            Layout.preferredHeight: visible ? 56 : 0
+
+            Row {
+                id: bars
+                anchors.left: parent.left
+                anchors.right: parent.right
+                anchors.top: parent.top
+                anchors.bottom: rangeLabels.top
+                anchors.bottomMargin: 2
+                spacing: 1
+
+                Repeater {
+                    model: chart.histogram?.counts ?? []
+                    delegate: Item {
+                        width: (bars.width - bars.spacing * (chart.histogram.counts.length - 1)) / chart.histogram.counts.length
+                        height: bars.height
+
+                        Rectangle {
+                            anchors.bottom: parent.bottom
+                            width: parent.width
+                            height: parent.height * modelData / chart.maximum
+                            color: "#7aa6da"
+                        }
+                    }
+                }
+            }
+
+            Label {
+                id: rangeLabels
+                anchors.left: parent.left
+                anchors.bottom: parent.bottom
+                font.family: "Source Sans 3"
+                font.pixelSize: 9
+                text: chart.visible ? Number(chart.histogram.from).toPrecision(3) : ""
+            }
 
-            Layout.alignment: Qt.AlignRight
-            text: typeof stat?.value === "number" && Math.floor(stat.value) !== stat.value
-                  ? stat.value.toFixed(3)
-                  : (stat?.value ?? "")
+            Label {
+                anchors.right: parent.right
+                anchors.bottom: parent.bottom
+                font.family: "Source Sans 3"
+                font.pixelSize: 9
+                text: chart.visible ? Number(chart.histogram.to).toPrecision(3) : ""
+            }
         }
     }
 }
@@ -33,6 +33,15 @@ Item {
             function onImageChanged(image) {
                 imageItem.setImage(image)
             }
+            function onPointsAppended(points) {
+                imageItem.appendPoints(points)
+            }
+            function onHeatmapAppended(heatmap) {
+                imageItem.appendHeatmap(heatmap)
+            }
+            function onPointsCleared() {
+                imageItem.clearPoints()
+            }
         }
     }
 
@@ -60,6 +69,24 @@ Item {
         }
     }
 
+    Text {
+        id: summaryText
+        anchors.right: parent.right
+        anchors.bottom: parent.bottom
+        anchors.rightMargin: root.propertiesExpanded ? 320 : 128
+        anchors.bottomMargin: 40
+        text: root.controller ? root.controller.summary : ""
+        color: "#a0a0a0"
+        visible: text !== ""
+
+        Behavior on anchors.rightMargin {
+            NumberAnimation {
+                duration: 240
+                easing.type: Easing.InOutQuad
+            }
+        }
+    }
+
     FocalButton {
         id: focalButton
         anchors.right: parent.right
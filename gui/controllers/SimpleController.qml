@@ -32,6 +32,24 @@ Item {
         }
     }
 
+    Text {
+        id: summaryText
+        anchors.right: parent.right
+        anchors.bottom: parent.bottom
+        anchors.rightMargin: root.propertiesExpanded ? 320 : 128
+        anchors.bottomMargin: 40
+        text: root.controller ? root.controller.summary : ""
+        color: "#a0a0a0"
+        visible: text !== ""
+
+        Behavior on anchors.rightMargin {
+            NumberAnimation {
+                duration: 240
+                easing.type: Easing.InOutQuad
+            }
+        }
+    }
+
     FocalButton {
         id: focalButton
         anchors.right: parent.right
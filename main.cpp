@@ -4,6 +4,9 @@
 #include <QQuickStyle>
 
 #include "simulationhandler.hpp"
+#include "api/accumulators.hpp"
+#include "api/heatmap.hpp"
+#include "api/points.hpp"
 
 
 int main(int argc, char *argv[])
@@ -15,6 +18,9 @@ int main(int argc, char *argv[])
     SimulationHandler handler;
 
     qRegisterMetaType<QImage>("QImage");
+    qRegisterMetaType<api::Points>("api::Points");
+    qRegisterMetaType<api::Heatmap>("api::Heatmap");
+    api::accumulator::registerConverters();
     engine.rootContext()->setContextProperty("simulationHandler", &handler);
 
     QObject::connect(
@@ -1,6 +1,7 @@
 #include "montecarlo.h"
 
 #include <QPainter>
+#include <array>
 #include <cmath>
 
 
@@ -17,13 +18,15 @@ MonteCarloSimulationDLL::MonteCarloSimulationDLL(QObject* parent)
     : QObject(parent)
 {
     m_properties = api::var("Symulacja", this,
-                            api::var<bool>("Animowanie", "Włącza rysowanie punktów na wykresie\npunktów wewnątrz i na zewnątrz koła", false));
+                            api::var<bool>("Animowanie", "Włącza rysowanie punktów na wykresie\npunktów wewnątrz i na zewnątrz koła", false),
+                            api::var<bool>("Mapa gęstości", "Zamiast pojedynczych punktów rysuje gęstość wylosowanych punktów\n(skala logarytmiczna), czytelną także dla milionów punktów", false));
 
     m_statistics = api::var(this,
-                            api::var<int>("Próby", "Całkowita liczba wylosowanych punktów", 0),
-                            api::var<int>("Wewnątrz koła", "Liczba punktów wewnątrz ćwiartki koła", 0),
+                            api::var<qint64>("Próby", "Całkowita liczba wylosowanych punktów", 0),
+                            api::var<qint64>("Wewnątrz koła", "Liczba punktów wewnątrz ćwiartki koła", 0),
                             api::var<double>("Oszacowanie π", "Aktualne oszacowanie liczby π", 0.0),
-                            api::var<double>("Błąd", "Błąd bezwzględny względem prawdziwej wartości π", 0.0));
+                            api::var<double>("Błąd", "Błąd bezwzględny względem prawdziwej wartości π", 0.0),
+                            api::var<double>("Średni kwadrat odległości", "Średnia wartość x² + y² wylosowanych punktów.\nWartość oczekiwana wynosi 2/3, można jej użyć jako zmiennej kontrolnej\nprzy zatrzymaniu na statystyce 'Oszacowanie π'", 0.0));
 }
 
 QString MonteCarloSimulationDLL::name() const
@@ -57,16 +60,38 @@ api::Variables MonteCarloSimulationDLL::statistics() const
     return m_statistics;
 }
 
+bool MonteCarloSimulationDLL::merge(api::VariableMap& total, const api::VariableWatchList& partial) const
+{
+    const auto totalTrials = total.ref<qint64>("Próby");
+    const auto partialTrials = partial.get<qint64>("Próby");
+    api::merge::weightedMean<double>(total, partial, "Średni kwadrat odległości", totalTrials, partialTrials);
+    api::merge::sum<qint64>(total, partial, "Próby");
+    api::merge::sum<qint64>(total, partial, "Wewnątrz koła");
+
+    // estimate is calculated again from merged counters
+    const auto trials = total.ref<qint64>("Próby");
+    const auto hits = total.ref<qint64>("Wewnątrz koła");
+    if (trials > 0)
+    {
+        auto& piEstimate = total.ref<double>("Oszacowanie π");
+        piEstimate = 4.0 * static_cast<double>(hits) / static_cast<double>(trials);
+        total.ref<double>("Błąd") = std::fabs(piEstimate - 4.0 * std::atan(1.0));
+    }
+    return true;
+}
+
 void MonteCarloSimulation::setup(api::VariableWatchList properties)
 {
     // Get properties
     animate = properties.get<bool>("Animowanie");
+    density = properties.get<bool>("Mapa gęstości");
 
     // Get statistics pointers
-    trials = &stats.ref<int>("Próby");
-    hits = &stats.ref<int>("Wewnątrz koła");
-    piEstimate = &stats.ref<double>("Oszacowanie π");
-    error = &stats.ref<double>("Błąd");
+    trials = stats.handle<qint64>("Próby");
+    hits = stats.handle<qint64>("Wewnątrz koła");
+    piEstimate = stats.handle<double>("Oszacowanie π");
+    error = stats.handle<double>("Błąd");
+    meanSquaredDistance = stats.handle<double>("Średni kwadrat odległości");
 
     // Setup animation if enabled
     if (animate)
@@ -114,13 +139,19 @@ void MonteCarloSimulation::setup(api::VariableWatchList properties)
         p.drawEllipse(legendPos, radius, radius);
         p.setPen(Qt::white);
         p.drawText(legendPos + QPoint(10, 4), "Poza kołem");
+
+        // one cell of the density map for every 2x2 pixels
+        if (density)
+            setHeatmap(QRectF(squareRect), side / 2, side / 2);
     }
 }
 
 void MonteCarloSimulation::run(api::NumberGenerator& generator)
 {
-    const double x = generator.real(0.0L, 1.0L);
-    const double y = generator.real(0.0L, 1.0L);
+    std::array<double, 2> point;
+    generator.point(point);
+    const double x = point[0];
+    const double y = point[1];
     const double dist2 = x * x + y * y;
 
     ++(*trials);
@@ -132,24 +163,22 @@ void MonteCarloSimulation::run(api::NumberGenerator& generator)
     // Pi ≈ 4 * hits / trials
     *piEstimate = 4.0 * static_cast<double>(*hits) / static_cast<double>(*trials);
 
+    *meanSquaredDistance += (dist2 - *meanSquaredDistance) / static_cast<double>(*trials);
+
     const double piTrue = 4.0 * std::atan(1.0); // π = 4 * arctan(1)
     *error = std::fabs(*piEstimate - piTrue);
 
     if (animate)
     {
-        QPainter p(&image);
-        p.setRenderHint(QPainter::Antialiasing, false);
-
+        // points are streamed to the UI, the image keeps only the background drawn in setup()
         const auto squarePosition = animationConfiguration.position();
         const auto squarePositionEnd = animationConfiguration.position() + animationConfiguration.size();
         const int px = map(x, 0.0L, 1.0L, squarePosition.x(), squarePositionEnd.x());
         const int py = map(y, 0.0L, 1.0L, squarePositionEnd.y(), squarePosition.y());
-        if (dist2 <= 1.0)
-            p.setPen(Qt::darkGreen);
+        if (density)
+            addSample(px, py);
         else
-            p.setPen(Qt::red);
-
-        p.drawPoint(px, py);
+            drawPoint(px, py, dist2 <= 1.0 ? QColor(Qt::darkGreen).rgb() : QColor(Qt::red).rgb());
     }
 }
 
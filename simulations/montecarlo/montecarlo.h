@@ -76,12 +76,14 @@ private:
 
     // --- Variables from properties ---
     bool animate = false;
+    bool density = false;
 
     // --- Variables for statistics ---
-    int* trials = nullptr;
-    int* hits = nullptr;
-    double* piEstimate = nullptr;
-    double* error = nullptr;
+    api::StatHandle<qint64> trials;
+    api::StatHandle<qint64> hits;
+    api::StatHandle<double> piEstimate;
+    api::StatHandle<double> error;
+    api::StatHandle<double> meanSquaredDistance;
 
     // --- Support variables for statistics ---
     // not present in UI but required to calculate others
@@ -102,6 +104,7 @@ public:
     api::ISimulation* create() const override;
     api::Variables properties() const override;
     api::Variables statistics() const override;
+    bool merge(api::VariableMap& total, const api::VariableWatchList& partial) const override;
 
 private:
     api::Variables m_properties;
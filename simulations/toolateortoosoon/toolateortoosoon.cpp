@@ -1,5 +1,6 @@
 #include "toolateortoosoon.h"
 
+#include <QDataStream>
 #include <QRegularExpression>
 #include <QPainter>
 
@@ -50,15 +51,18 @@ TooLateOrTooSoonSimulationDLL::TooLateOrTooSoonSimulationDLL(QObject* parent)
         api::var("Chłopiec",
             api::var<QString>("Najwcześniej", "Najwcześniejsza godzina przyjazdu chłopca na przystanek\nFormat hh:mm lub hh:mm:ss <00:00, 23:59:59>", "7:55", matchTimeFormat),
             api::var<QString>("Najpóźniej", "Najpóźniejsza godzina przyjazdu chłopca na przystanek\nFormat hh:mm lub hh:mm:ss <00:00, 23:59:59>", "8:01", matchTimeFormat)),
-        api::var<bool>("Animowanie", "Włacza rysowanie wykresu z zaznaczonymi punktami przyjazdów\nautobusu oraz chłopca", false));
+        api::var<bool>("Animowanie", "Włacza rysowanie wykresu z zaznaczonymi punktami przyjazdów\nautobusu oraz chłopca", false),
+        api::var<bool>("Mapa gęstości", "Zamiast pojedynczych punktów rysuje gęstość przyjazdów\n(skala logarytmiczna), czytelną także dla milionów prób", false));
     m_statistics = api::var(this,
-        api::var<int>("Próby", "Liczba prób", 0),
-        api::var<int>("Na czas", "Ile razy chłopiec zdążył na autobus", 0),
-        api::var<int>("Najdłuższa seria na czas", "Najdłuższa seria dni, gdy chłopiec był na czas", 0),
-        api::var<QString>("Średni czas czekania", "Średni czas oczekiwania, gdy chłopiec się nie spóźnił", "00:00:00"),
-        api::var<int>("Spóźnienia", "Ile razy chłopiec spóźnił się na autobus", 0),
-        api::var<QString>("Średnie spóźnienie", "Średni czas spóźnienia, gdy chłopiec przyjechał zbyt późno", "00:00:00"),
-        api::var<int>("Najdłuższa seria spóźnień", "Najdłuższa seria dni, gdy chłopiec się spóźnił", 0),
+        api::var<qint64>("Próby", "Liczba prób", 0),
+        api::var<qint64>("Na czas", "Ile razy chłopiec zdążył na autobus", 0),
+        api::var<qint64>("Najdłuższa seria na czas", "Najdłuższa seria dni, gdy chłopiec był na czas", 0),
+        api::var<api::accumulator::Mean>("Średni czas czekania", "Średni czas oczekiwania w sekundach (± błąd standardowy),\ngdy chłopiec się nie spóźnił"),
+        api::var<qint64>("Spóźnienia", "Ile razy chłopiec spóźnił się na autobus", 0),
+        api::var<api::accumulator::Mean>("Średnie spóźnienie", "Średni czas spóźnienia w sekundach (± błąd standardowy),\ngdy chłopiec przyjechał zbyt późno"),
+        api::var<api::accumulator::Histogram>("Rozkład spóźnień", "Rozkład czasu spóźnienia w sekundach,\nprzedział rośnie wraz z najdłuższym spóźnieniem",
+                                              api::accumulator::Histogram{0.0, 16.0, 16, api::accumulator::Histogram::Scale::Adaptive}),
+        api::var<qint64>("Najdłuższa seria spóźnień", "Najdłuższa seria dni, gdy chłopiec się spóźnił", 0),
         api::var<double>("Procent spóźnień", "Stostunek spóźnień do wszystkich prób", 0.0));
 }
 
@@ -96,6 +100,27 @@ api::Variables TooLateOrTooSoonSimulationDLL::statistics() const
     return m_statistics;
 }
 
+bool TooLateOrTooSoonSimulationDLL::merge(api::VariableMap& total, const api::VariableWatchList& partial) const
+{
+    // average times keep their own counts of samples
+    api::merge::accumulate<api::accumulator::Mean>(total, partial, "Średni czas czekania");
+    api::merge::accumulate<api::accumulator::Mean>(total, partial, "Średnie spóźnienie");
+    api::merge::accumulate<api::accumulator::Histogram>(total, partial, "Rozkład spóźnień");
+
+    api::merge::sum<qint64>(total, partial, "Próby");
+    api::merge::sum<qint64>(total, partial, "Na czas");
+    api::merge::sum<qint64>(total, partial, "Spóźnienia");
+
+    // series are not continued between instances, take the longest one
+    api::merge::maximum<qint64>(total, partial, "Najdłuższa seria na czas");
+    api::merge::maximum<qint64>(total, partial, "Najdłuższa seria spóźnień");
+
+    const auto trials = total.ref<qint64>("Próby");
+    if (trials > 0)
+        total.ref<double>("Procent spóźnień") = static_cast<double>(total.ref<qint64>("Spóźnienia")) * 100.0 / static_cast<double>(trials);
+    return true;
+}
+
 void TooLateOrTooSoonSimulation::setup(api::VariableWatchList properties)
 {
     // Get properties as QString
@@ -104,6 +129,7 @@ void TooLateOrTooSoonSimulation::setup(api::VariableWatchList properties)
     auto boyArrivalFromStr = properties.get<QString>("Chłopiec:Najwcześniej");
     auto boyArrivalToStr = properties.get<QString>("Chłopiec:Najpóźniej");
     animate = properties.get<bool>("Animowanie");
+    density = properties.get<bool>("Mapa gęstości");
 
     // Converted properties from QString "hh:mm" or "hh:mm:ss" to seconds since midnight
     busArrivalFrom = convertTime(busArrivalFromStr);
@@ -126,14 +152,15 @@ void TooLateOrTooSoonSimulation::setup(api::VariableWatchList properties)
     }
 
     // Get statistics pointers to update variables in run
-    trials = &stats.ref<int>("Próby");
-    onTime = &stats.ref<int>("Na czas");
-    late = &stats.ref<int>("Spóźnienia");
-    averageWaitingTime = &stats.ref<QString>("Średni czas czekania");
-    averageDelayTime = &stats.ref<QString>("Średnie spóźnienie");
-    longestOnTimeSeries = &stats.ref<int>("Najdłuższa seria na czas");
-    longestLateSeries = &stats.ref<int>("Najdłuższa seria spóźnień");
-    percentOfDelays = &stats.ref<double>("Procent spóźnień");
+    trials = stats.handle<qint64>("Próby");
+    onTime = stats.handle<qint64>("Na czas");
+    late = stats.handle<qint64>("Spóźnienia");
+    averageWaitingTime = stats.handle<api::accumulator::Mean>("Średni czas czekania");
+    averageDelayTime = stats.handle<api::accumulator::Mean>("Średnie spóźnienie");
+    delayDistribution = stats.handle<api::accumulator::Histogram>("Rozkład spóźnień");
+    longestOnTimeSeries = stats.handle<qint64>("Najdłuższa seria na czas");
+    longestLateSeries = stats.handle<qint64>("Najdłuższa seria spóźnień");
+    percentOfDelays = stats.handle<double>("Procent spóźnień");
 
     // If animations enabled, prepare view
     if (animate)
@@ -201,52 +228,56 @@ void TooLateOrTooSoonSimulation::setup(api::VariableWatchList properties)
         p.drawEllipse(rowPosition, radius, radius);
         p.setPen(Qt::white);
         p.drawText(rowPosition + textOffset, QStringLiteral("Spóźniony"));
+
+        // the density map covers the plot, one cell for every 2x2 pixels
+        if (density)
+        {
+            const auto plot = QRect(QPoint(animationConfiguration.axisCenter().x(), animationConfiguration.axisYMaxPoint().y()),
+                                    QPoint(animationConfiguration.axisXMaxPoint().x(), animationConfiguration.axisCenter().y()));
+            setHeatmap(QRectF(plot), std::max(plot.width() / 2, 1), std::max(plot.height() / 2, 1));
+        }
     }
 }
 
 void TooLateOrTooSoonSimulation::run(api::NumberGenerator& generator)
 {
-    const auto busArrivalTime = generator(busArrivalFrom, busArrivalTo);
-    const auto boyArrivalTime = generator(boyArrivalFrom, boyArrivalTo);
+    const auto busArrivalTime = generator.uniformInt(busArrivalFrom, busArrivalTo);
+    const auto boyArrivalTime = generator.uniformInt(boyArrivalFrom, boyArrivalTo);
 
     ++(*trials);
     if (boyArrivalTime <= busArrivalTime)
     {
         // Boy is on time
         ++(*onTime);
-        const int64_t waitingTime = busArrivalTime - boyArrivalTime;
-        totalWaitingTimeInt += waitingTime;
-        *averageWaitingTime = convertToTime(totalWaitingTimeInt / static_cast<int64_t>(*onTime));
-        series = std::max(series + 1, 1);
+        averageWaitingTime->add(busArrivalTime - boyArrivalTime);
+        series = std::max<qint64>(series + 1, 1);
         *longestOnTimeSeries = std::max(*longestOnTimeSeries, series);
     }
     else
     {
         // Boy is late
         ++(*late);
-        const int64_t delayTime = boyArrivalTime - busArrivalTime;
-        totalDelayTimeInt += delayTime;
-        *averageDelayTime = convertToTime(totalDelayTimeInt / static_cast<int64_t>(*late));
-        series = std::min(series - 1, -1);
+        averageDelayTime->add(boyArrivalTime - busArrivalTime);
+        delayDistribution->add(boyArrivalTime - busArrivalTime);
+        series = std::min<qint64>(series - 1, -1);
         *longestLateSeries = std::max(*longestLateSeries, -series);
     }
-    *percentOfDelays = static_cast<double>(*late * 100) / static_cast<double>(*trials);
+    *percentOfDelays = static_cast<double>(*late) * 100.0 / static_cast<double>(*trials);
 
     if (animate)
     {
-        QPainter p(&image);
-        p.setRenderHint(QPainter::Antialiasing, false);
-        if (boyArrivalTime <= busArrivalTime)
-            p.setPen(Qt::darkGreen);
-        else
-            p.setPen(Qt::red);
+        // points are streamed to the UI, the image keeps only the background drawn in setup()
         const auto boyArrivalTimeOnAxisScale = map(boyArrivalTime, boyArrivalFrom, boyArrivalTo,
                                                    animationConfiguration.axisCenter().x(),
                                                    animationConfiguration.axisXMaxPoint().x());
         const auto busArrivalTimeOnAxisScale = map(busArrivalTime, busArrivalFrom, busArrivalTo,
                                                    animationConfiguration.axisCenter().y(),
                                                    animationConfiguration.axisYMaxPoint().y());
-        p.drawPoint(boyArrivalTimeOnAxisScale, busArrivalTimeOnAxisScale);
+        if (density)
+            addSample(boyArrivalTimeOnAxisScale, busArrivalTimeOnAxisScale);
+        else
+            drawPoint(boyArrivalTimeOnAxisScale, busArrivalTimeOnAxisScale,
+                      boyArrivalTime <= busArrivalTime ? QColor(Qt::darkGreen).rgb() : QColor(Qt::red).rgb());
     }
 }
 
@@ -254,3 +285,18 @@ void TooLateOrTooSoonSimulation::teardown()
 {
     /* nothing to do on clear in this simulation */
 }
+
+QByteArray TooLateOrTooSoonSimulation::saveState() const
+{
+    // series are continued from this value after resume, averages are restored with statistics
+    QByteArray state;
+    QDataStream stream(&state, QIODevice::WriteOnly);
+    stream << series;
+    return state;
+}
+
+void TooLateOrTooSoonSimulation::restoreState(const QByteArray& state)
+{
+    QDataStream stream(state);
+    stream >> series;
+}
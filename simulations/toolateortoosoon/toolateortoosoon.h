@@ -165,6 +165,8 @@ public:
     void setup(api::VariableWatchList properties) override;
     void run(api::NumberGenerator& generator) override;
     void teardown() override;
+    QByteArray saveState() const override;
+    void restoreState(const QByteArray& state) override;
 
 private:
     toolateortoosoon::AnimationConfiguration animationConfiguration;
@@ -175,22 +177,22 @@ private:
     int boyArrivalFrom = 0;
     int boyArrivalTo = 0;
     bool animate = false;
+    bool density = false;
 
     // --- Variables for statistics ---
-    int* trials = nullptr;
-    int* onTime = nullptr;
-    int* late = nullptr;
-    QString* averageWaitingTime = nullptr;
-    QString* averageDelayTime = nullptr;
-    int* longestOnTimeSeries = nullptr;
-    int* longestLateSeries = nullptr;
-    double* percentOfDelays = nullptr;
+    api::StatHandle<qint64> trials;
+    api::StatHandle<qint64> onTime;
+    api::StatHandle<qint64> late;
+    api::StatHandle<api::accumulator::Mean> averageWaitingTime;
+    api::StatHandle<api::accumulator::Mean> averageDelayTime;
+    api::StatHandle<api::accumulator::Histogram> delayDistribution;
+    api::StatHandle<qint64> longestOnTimeSeries;
+    api::StatHandle<qint64> longestLateSeries;
+    api::StatHandle<double> percentOfDelays;
 
     // --- Support variables for statistics ---
     // not present in UI but required to calculate others
-    int64_t totalWaitingTimeInt = 0;
-    int64_t totalDelayTimeInt = 0;
-    int series = 0;
+    qint64 series = 0;
     int currentRow = 0;
 };
 
@@ -209,6 +211,7 @@ public:
     api::ISimulation* create() const override;
     api::Variables properties() const override;
     api::Variables statistics() const override;
+    bool merge(api::VariableMap& total, const api::VariableWatchList& partial) const override;
 
 private:
     api::Variables m_properties;
@@ -17,7 +17,7 @@ class Property : public IAdapter
 
     Q_PROPERTY(QString label READ label CONSTANT)
     Q_PROPERTY(QString hint READ hint CONSTANT)
-    Q_PROPERTY(QString type READ type CONSTANT)      // "text" / "int" / "double" / "bool"
+    Q_PROPERTY(QString type READ type CONSTANT)      // "text" / "int" / "int64" / "uint64" / "double" / "bool"
     Q_PROPERTY(QVariant value READ value WRITE setValue NOTIFY changed)
     Q_PROPERTY(bool isGroup READ isGroup CONSTANT)
     Q_PROPERTY(int groupDepth READ groupDepth CONSTANT)
@@ -51,6 +51,10 @@ public:
         switch (mt.id()) {
         case QMetaType::Int:
             return "int";
+        case QMetaType::LongLong:
+            return "int64";
+        case QMetaType::ULongLong:
+            return "uint64";
         case QMetaType::Double:
             return "double";
         case QMetaType::Bool:
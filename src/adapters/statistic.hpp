@@ -3,6 +3,7 @@
 #include <QObject>
 #include <QPointer>
 #include <QVariant>
+#include <cmath>
 
 #include "api/variable.hpp"
 #include "iadapter.hpp"
@@ -18,6 +19,8 @@ class Statistic : public IAdapter
     Q_PROPERTY(QString label READ label CONSTANT)
     Q_PROPERTY(QString hint READ hint CONSTANT)
     Q_PROPERTY(QVariant value READ value NOTIFY changed)
+    Q_PROPERTY(QVariant error READ error NOTIFY changed)
+    Q_PROPERTY(QVariant histogram READ histogram NOTIFY changed)
 
 public:
     explicit Statistic(QString label,
@@ -44,7 +47,32 @@ public:
 
     QVariant value() const
     {
-        return m_watchedVariables[m_id];
+        // accumulators are shown by their value, other custom types as text
+        const auto value = m_watchedVariables[m_id];
+        if (value.metaType() == QMetaType::fromType<api::accumulator::Histogram>())
+            return value.value<api::accumulator::Histogram>().total();
+        if (const auto estimate = api::accumulator::estimate(value))
+            return estimate->value;
+        if (value.metaType().id() >= QMetaType::User && value.canConvert<QString>())
+            return value.toString();
+        return value;
+    }
+
+    QVariant error() const
+    {
+        // standard error of accumulators, undefined in QML if unknown
+        if (const auto estimate = api::accumulator::estimate(m_watchedVariables[m_id]); estimate && std::isfinite(estimate->error))
+            return estimate->error;
+        return QVariant{};
+    }
+
+    QVariant histogram() const
+    {
+        // bins of histograms drawn as a bar chart, undefined in QML for other statistics
+        const auto value = m_watchedVariables[m_id];
+        if (value.metaType() == QMetaType::fromType<api::accumulator::Histogram>())
+            return value.value<api::accumulator::Histogram>().toMap();
+        return QVariant{};
     }
 
     QObject* raw()
@@ -1,98 +1,52 @@
 #pragma once
 
 #include <QObject>
-#include <QQmlEngine>
 #include <QImage>
-#include <QThread>
-#include <chrono>
 
-#include "icontroller.hpp"
-#include "providers/statistics.hpp"
-#include "ControllerState.hpp"
+#include "batchcontroller.hpp"
 
 
 namespace api
 {
 class ISimulationDLL;
 class AnimatedSimulation;
-class NumberGenerator;
 }  // namespace api
 
 
 namespace controllers
 {
 
-class AnimatedController : public IController
+class AnimatedController : public BatchController
 {
     Q_OBJECT
 
-    Q_PROPERTY(ControllerState::State state READ state NOTIFY stateChanged)
     Q_PROPERTY(QImage image READ image NOTIFY imageChanged)
 
-    struct SimulationControlParams
-    {
-        std::unique_ptr<api::NumberGenerator> numberGenerator;
-        std::chrono::time_point<std::chrono::high_resolution_clock> lastRunTimestamp;
-        int minDelayBetweenRuns;
-        int currentIteration;
-        int iterations;
-    };
-
 public:
     AnimatedController(api::ISimulationDLL* plugin,
                        QObject* parent = nullptr);
-    ~AnimatedController();
-
-    Q_INVOKABLE void start();
-    Q_INVOKABLE void pause();
-    Q_INVOKABLE void stop();
-    Q_INVOKABLE void restart();
 
     QUrl uiSource() const override;
-    api::Variables properties() override;
-    providers::IProvider* statistics() override;
 
-    ControllerState::State state() const;
     QImage image() const;
 
 signals:
-    void stateChanged(const ControllerState::State &image);
     void imageChanged(const QImage &image);
-    void error(const QString& message);
-
-    void setupSimulation(api::Variables properties, api::Variables statistics); // clazy:exclude=fully-qualified-moc-types
-    void runSimulation(api::NumberGenerator* generator);
-    void teardownSimulation();
-
-private slots:
-    void onSimulationReadyToRun(const api::VariableMapSnapshot& update, const QImage& image);
-    void onSimulationUpdateProgress(const api::VariableMapSnapshot& update);
-    void onSimulationRunFinished(const api::VariableMapSnapshot& update, const QImage& image);
-    void onSimulationError(const QString& message);
+    void pointsAppended(const api::Points& points);
+    void heatmapAppended(const api::Heatmap& heatmap);
+    void pointsCleared();
 
 private:
-    void prepareSimulationThread();
-    void quitSimulationThread();
-    bool isSimulationExists() const;
-    void nextRun();
-
-    void bindSignals(api::AnimatedSimulation* simulation);
-    void simulationStart();
-
-    void simulationStop();
-    void simulationRestart();
+    api::AnimatedSimulation* simulationOf(int replica) const;
+    void bindSignals(api::ISimulation* simulation, int replica) override;
+    void invokeSetup(int replica, api::Variables properties, api::Variables statistics) override;
+    void invokeBatch(int replica, api::NumberGenerator* generator, qint64 firstIteration, qint64 iterations) override;
+    void invokeTeardown(int replica) override;
+    void invokeRestore(int replica, const Checkpoint::ReplicaState& state) override;
 
-    void transitionTo(ControllerState::State state);
-    void redraw(const QImage& image);
+    void redraw(const api::Points& points, const api::Heatmap& heatmap);
 
 private:
-    api::ISimulationDLL* m_plugin;
-    providers::Statistics m_statistics;
-    api::Variables m_properties;
-    QThread* m_simulationThread;
-    ControllerState::State m_state;
-    bool m_isBusy;
-    SimulationControlParams m_controlParams;
     QImage m_image;
 };
 
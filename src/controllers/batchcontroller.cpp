@@ -0,0 +1,611 @@
+#include "batchcontroller.hpp"
+
+#include <QFile>
+#include <QTime>
+#include <QTimer>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "api/simulation.hpp"
+#include "tools/numbergeneratorfactory.hpp"
+#include "tools/variancereductionnumbergenerator.hpp"
+
+
+namespace controllers
+{
+
+namespace
+{
+QTime parseTime(const QString& value)
+{
+    auto time = QTime::fromString(value, "h:mm:ss");
+    return time.isValid() ? time : QTime::fromString(value, "h:mm");
+}
+}  // namespace
+
+
+BatchController::BatchController(api::ISimulationDLL* plugin,
+                                 QObject* parent)
+    : IController(parent)
+    , m_plugin{plugin}
+    , m_statistics{plugin->statistics()}
+    , m_properties{nullptr}
+    , m_state{ControllerState::Ready}
+    , m_isBusy{false}
+    , m_isNextRunScheduled{false}
+    , m_isCheckpointPending{false}
+    , m_checkpointInterval{0}
+    , m_publisher{&m_statistics, [this]() { return publishStatistics(); }}
+{
+    m_properties = api::var("Przebieg", this,
+                            api::var<qint64>("Liczba przebiegów", "Liczba powtórzeń symulacji, im większa, tym dokładniejsze wyniki (liczba dodatnia)", 100, [](const qint64& value) { return 0 < value; }),
+                            api::var<int>("Limit czasu", "Czas trwania symulacji w sekundach <0, 604'800>.\nSymulacja wykonuje tyle przebiegów, ile zdąży, liczba przebiegów jest pomijana.\nUstaw 0, aby wykonać wszystkie przebiegi", 0, [](const int& value) { return 0 <= value && value <= 604'800; }),
+                            api::var<QString>("Termin", "Godzina zakończenia symulacji w formacie hh:mm lub hh:mm:ss.\nSymulacja wykonuje tyle przebiegów, ile zdąży, liczba przebiegów jest pomijana.\nPozostaw puste, aby nie ograniczać czasu", "", [](const QString& value) { return value.isEmpty() || parseTime(value).isValid(); }),
+                            api::var<int>("Ziarno", "Ustalona wartość inicjalizująca\ngenerator losowy w celu powtarzalności wyników (random seed).\nUstaw 0 dla losowego ziarna, użyte ziarno jest wyświetlane\nw podsumowaniu, aby można było powtórzyć przebieg", 0, [](const int& value) { return true; }),
+                            api::var<QString>("Generator", "Algorytm generatora liczb losowych:\nmt19937 - każdy wątek ma własny strumień liczb,\nphilox - liczby przebiegu zależą tylko od ziarna i numeru przebiegu,\nstatystyki całkowite nie zależą od liczby wątków,\nzmiennoprzecinkowe - z dokładnością do zaokrągleń,\nxoshiro256**, pcg64, splitmix64 - szybkie generatory o małym stanie,\nwątki korzystają z rozłącznych podciągów jednego ciągu liczb,\nsobol, halton - ciągi quasi-losowe o niskiej rozbieżności, szybciej zbieżne\nw całkowaniu, przebieg otrzymuje kolejny punkt ciągu przesunięty losowo.\nBłąd wyniku ocenia się, powtarzając symulację z różnymi ziarnami", "mt19937", [](const QString& value) { return tools::NumberGeneratorFactory::engine(value).has_value(); }),
+                            api::var<int>("Opóźnienie", "Opóźnienie pomiędzy kolejnymi iteracjami (w milisekundach <0-3000>)", 0, [](const int& value) { return 0 <= value && value <= 3000; }),
+                            api::var<int>("Liczba wątków", "Liczba instancji symulacji uruchomionych równolegle <1, 256>,\nkażda z niezależnym strumieniem liczb losowych.\nSymulacje nieobsługujące łączenia statystyk używają jednego wątku", 1, [](const int& value) { return 0 < value && value <= 256; }),
+                            api::var("Zatrzymanie",
+                                     api::var<QString>("Statystyka", "Nazwa statystyki liczbowej, której dokładność kończy symulację\nprzed wykonaniem wszystkich przebiegów.\nPozostaw puste, aby wykonać wszystkie przebiegi", ""),
+                                     api::var<double>("Dokładność", "Docelowa połowa szerokości przedziału ufności statystyki", 0.001, [](const double& value) { return 0.0 < value; }),
+                                     api::var<double>("Poziom ufności", "Poziom ufności przedziału (0, 1)", 0.95, [](const double& value) { return 0.0 < value && value < 1.0; })),
+                            api::var("Redukcja wariancji",
+                                     api::var<bool>("Zmienne antytetyczne", "Co drugi przebieg używa liczb 1 - u, gdzie u to liczby poprzedniego przebiegu.\nUjemna korelacja pary zmniejsza wariancję statystyk monotonicznych", false),
+                                     api::var<int>("Warstwowanie", "Liczba pierwszych liczb losowych przebiegu <0, 8>, które w każdej paczce\nprzebiegów pokrywają równomiernie przedział <0, 1) (hiperkostka łacińska).\nWyniki zależą wtedy od podziału na paczki i liczby wątków.\nUstaw 0, aby nie warstwować", 0, [](const int& value) { return 0 <= value && value <= api::VarianceReductionNumberGenerator::maxStratifiedDimensions; }),
+                                     api::var<QString>("Zmienna kontrolna", "Nazwa statystyki liczbowej o znanej wartości oczekiwanej, skorelowanej\nze statystyką zatrzymania. Jej odchylenie od wartości oczekiwanej koryguje wynik.\nWymaga ustawienia statystyki zatrzymania. Pozostaw puste, aby nie korygować", ""),
+                                     api::var<double>("Wartość oczekiwana", "Dokładna wartość oczekiwana zmiennej kontrolnej", 0.0)),
+                            api::var<int>("Odświeżanie", "Najkrótszy czas pomiędzy aktualizacjami statystyk na ekranie\n(w milisekundach <0-5000>), niezależny od opóźnienia.\n16 ms odpowiada 60 aktualizacjom na sekundę, 0 pokazuje każdą aktualizację", StatisticsPublisher::defaultInterval, [](const int& value) { return 0 <= value && value <= 5000; }),
+                            api::var("Punkt kontrolny",
+                                     api::var<QString>("Plik", "Ścieżka pliku, do którego okresowo zapisywany jest stan symulacji,\npozwalający ją wznowić po zamknięciu aplikacji.\nPozostaw puste, aby nie zapisywać", ""),
+                                     api::var<int>("Interwał", "Czas pomiędzy kolejnymi zapisami (w sekundach <1, 86'400>)", 60, [](const int& value) { return 0 < value && value <= 86'400; }),
+                                     api::var<bool>("Wznów", "Wznawia symulację z pliku punktu kontrolnego, jeśli plik istnieje.\nWłaściwości symulacji i liczba wątków są odczytywane z pliku", false)));
+}
+
+BatchController::~BatchController()
+{
+    quitSimulationThread();
+}
+
+api::Variables BatchController::properties()
+{
+    return m_properties;
+}
+
+providers::IProvider* BatchController::statistics()
+{
+    return &m_statistics;
+}
+
+ControllerState::State BatchController::state() const
+{
+    return m_state;
+}
+
+QString BatchController::summary() const
+{
+    return m_summary;
+}
+
+void BatchController::transitionTo(ControllerState::State state)
+{
+    m_state = state;
+    m_isBusy = false;
+    emit stateChanged(m_state);
+}
+
+void BatchController::prepareSimulationThread()
+{
+    Q_ASSERT(m_replicas.empty());
+    prepareReplica(0);
+}
+
+void BatchController::prepareReplica(int replica)
+{
+    Q_ASSERT(replica == static_cast<int>(m_replicas.size()));
+    auto& entry = m_replicas.emplace_back();
+    entry.thread = new QThread(this);
+    auto simulation = m_plugin->create();
+    entry.simulation = simulation;
+
+    // lifecycle signals depend on the type of the simulation
+    bindSignals(simulation, replica);
+
+    // update simulation statistics if library calls
+    QObject::connect(simulation, &api::ISimulation::progress, this,
+                     [this, replica](const api::VariableMapSnapshot& update) { onSimulationUpdateProgress(replica, update); });
+
+    // destroy object on thread end
+    QObject::connect(entry.thread, &QThread::destroyed,
+                     simulation, &QObject::deleteLater);
+
+    // display error on screen if reported by the simulation
+    QObject::connect(simulation, &api::ISimulation::error,
+                     this, &controllers::BatchController::onSimulationError);
+
+    simulation->moveToThread(entry.thread);
+    entry.thread->start();
+}
+
+void BatchController::releaseReplica()
+{
+    auto& replica = m_replicas.back();
+    replica.thread->quit();
+    replica.thread->wait();
+    delete replica.thread;
+    m_replicas.pop_back();
+}
+
+void BatchController::quitSimulationThread()
+{
+    while (!m_replicas.empty())
+        releaseReplica();
+    m_merger.reset();
+    m_convergence.reset();
+    m_resume.reset();
+}
+
+bool BatchController::isReplica(int replica) const
+{
+    return 0 <= replica && replica < static_cast<int>(m_replicas.size());
+}
+
+api::ISimulation* BatchController::simulation(int replica) const
+{
+    return m_replicas[replica].simulation;
+}
+
+std::optional<api::VariableMapSnapshot> BatchController::collectStatistics()
+{
+    if (m_replicas.empty())
+        return std::nullopt;
+    if (m_merger)
+        return m_merger->merge(m_replicas);
+    return m_replicas.front().lastUpdate;
+}
+
+std::optional<api::VariableMapSnapshot> BatchController::publishStatistics()
+{
+    // statistics are merged only when published, convergence is checked on the same snapshot
+    auto snapshot = collectStatistics();
+    if (snapshot && m_convergence)
+    {
+        m_convergence->update(*snapshot, m_controlParams.completedIterations);
+        if (m_convergence->isConverged())
+            m_controlParams.finish();
+    }
+    return snapshot;
+}
+
+void BatchController::onSimulationUpdateProgress(int replica, const api::VariableMapSnapshot& update)
+{
+    if (!isReplica(replica))
+        return;
+    m_replicas[replica].lastUpdate = update;
+    m_publisher.invalidate();
+}
+
+void BatchController::onSimulationRunFinished(int replica, const api::VariableMapSnapshot& update)
+{
+    if (!isReplica(replica))
+        return;
+    auto& entry = m_replicas[replica];
+    entry.isBusy = false;
+    entry.lastUpdate = update;
+    m_controlParams.batchFinished(std::chrono::high_resolution_clock::now() - entry.batchTimestamp, entry.batchIterations);
+    m_controlParams.completedIterations += entry.batchIterations;
+    m_publisher.invalidate();
+    nextRun();
+}
+
+void BatchController::onSimulationTeardownFinished(int replica)
+{
+    if (!isReplica(replica))
+        return;
+    m_replicas[replica].isFinished = true;
+    if (std::all_of(m_replicas.begin(), m_replicas.end(), [](const auto& entry) { return entry.isFinished; }))
+        simulationStop();
+}
+
+void BatchController::onSimulationError(const QString& message)
+{
+    if (m_replicas.empty())
+        return;
+    simulationStop();
+    emit error(message);
+}
+
+void BatchController::simulationStart()
+{
+    auto propertyMap = api::VariableMap(m_properties);
+    const auto& checkpointPath = propertyMap.ref<QString>("Plik");
+    m_resume.reset();
+    if (!checkpointPath.isEmpty() && propertyMap.ref<bool>("Wznów") && QFile::exists(checkpointPath))
+    {
+        try
+        {
+            auto checkpoint = Checkpoint::read(checkpointPath);
+            if (checkpoint.simulation != m_plugin->name())
+                throw std::runtime_error{QString("Punkt kontrolny '%1' należy do symulacji '%2'").arg(checkpointPath, checkpoint.simulation).toStdString()};
+            const auto& settings = checkpoint.settings;
+            if (!tools::NumberGeneratorFactory::engine(settings.generator) ||
+                settings.stratifiedDimensions < 0 || settings.stratifiedDimensions > api::VarianceReductionNumberGenerator::maxStratifiedDimensions)
+                throw std::runtime_error{QString("Punkt kontrolny '%1' zawiera nieprawidłowe ustawienia generatora").arg(checkpointPath).toStdString()};
+            api::VariableMap(m_plugin->properties()).restore(checkpoint.properties);
+            // random numbers continue only with the generator and the settings of the saved run
+            propertyMap.ref<QString>("Generator") = settings.generator;
+            propertyMap.ref<bool>("Zmienne antytetyczne") = settings.isAntithetic;
+            propertyMap.ref<int>("Warstwowanie") = settings.stratifiedDimensions;
+            propertyMap.ref<qint64>("Liczba przebiegów") = settings.iterations;
+            propertyMap.ref<int>("Limit czasu") = settings.timeLimit;
+            propertyMap.ref<QString>("Termin") = settings.deadline;
+            m_resume = std::move(checkpoint);
+        }
+        catch (std::runtime_error& e)
+        {
+            transitionTo(ControllerState::Ready);
+            emit error(QString::fromStdString(e.what()));
+            return;
+        }
+    }
+    m_checkpointPath = checkpointPath;
+    m_checkpointInterval = propertyMap.ref<int>("Interwał");
+    m_isCheckpointPending = false;
+
+    qint64 iterations = propertyMap.ref<qint64>("Liczba przebiegów");
+    int seed = propertyMap.ref<int>("Ziarno");
+    const auto engine = *tools::NumberGeneratorFactory::engine(propertyMap.ref<QString>("Generator"));
+    int delayBetweenRuns = propertyMap.ref<int>("Opóźnienie");
+    int replicas = propertyMap.ref<int>("Liczba wątków");
+    int timeLimit = propertyMap.ref<int>("Limit czasu");
+    m_publisher.setInterval(propertyMap.ref<int>("Odświeżanie"));
+    const auto& deadline = propertyMap.ref<QString>("Termin");
+    const auto& convergenceStatistic = propertyMap.ref<QString>("Statystyka");
+
+    const auto isAntithetic = propertyMap.ref<bool>("Zmienne antytetyczne");
+    const auto stratifiedDimensions = propertyMap.ref<int>("Warstwowanie");
+    const auto& controlVariate = propertyMap.ref<QString>("Zmienna kontrolna");
+
+    m_convergence.reset();
+    if (!controlVariate.isEmpty() && convergenceStatistic.isEmpty())
+    {
+        transitionTo(ControllerState::Ready);
+        emit error("Zmienna kontrolna wymaga ustawienia statystyki zatrzymania");
+        return;
+    }
+    if (!convergenceStatistic.isEmpty())
+    {
+        try
+        {
+            m_convergence.emplace(m_plugin->statistics(), convergenceStatistic,
+                                  propertyMap.ref<double>("Dokładność"), propertyMap.ref<double>("Poziom ufności"));
+            if (!controlVariate.isEmpty())
+                m_convergence->setControlVariate(controlVariate, propertyMap.ref<double>("Wartość oczekiwana"));
+        }
+        catch (std::runtime_error& e)
+        {
+            transitionTo(ControllerState::Ready);
+            emit error(QString::fromStdString(e.what()));
+            return;
+        }
+        if (m_resume && !m_resume->convergence.isEmpty())
+            m_convergence->restoreState(m_resume->convergence);
+    }
+
+    // resumed simulation continues with the same replicas
+    if (m_resume)
+        replicas = static_cast<int>(m_resume->replicas.size());
+
+    m_merger.reset();
+    if (replicas > 1)
+    {
+        m_merger = std::make_unique<StatisticsMerger>(m_plugin);
+        if (!m_merger->isSupported())
+        {
+            m_merger.reset();
+            replicas = 1;
+        }
+    }
+    if (m_resume && replicas != static_cast<int>(m_resume->replicas.size()))
+    {
+        const auto checkpointReplicas = m_resume->replicas.size();
+        m_resume.reset();
+        transitionTo(ControllerState::Ready);
+        emit error(QString("Punkt kontrolny zawiera %1 wątków, a symulacja nie obsługuje łączenia statystyk").arg(checkpointReplicas));
+        return;
+    }
+    m_runSettings = Checkpoint::Settings{propertyMap.ref<QString>("Generator"), isAntithetic, stratifiedDimensions,
+                                         iterations, timeLimit, deadline};
+
+    auto params = SimulationControlParams{};
+    params.currentIteration = 0;
+    params.completedIterations = 0;
+    params.iterations = iterations;
+    params.minDelayBetweenRuns = delayBetweenRuns;
+    const auto now = std::chrono::high_resolution_clock::now();
+    params.startTimestamp = now;
+    params.lastRunTimestamp = now;
+    m_lastCheckpointTimestamp = now;
+    params.iterationsPerSecond = 0.0;
+    if (timeLimit > 0 || !deadline.isEmpty())
+    {
+        auto budget = std::chrono::seconds{std::numeric_limits<int>::max()};
+        if (timeLimit > 0)
+        {
+            // resumed run has only the rest of its time limit
+            const auto elapsedSeconds = m_resume ? std::llround(m_resume->elapsedSeconds) : 0LL;
+            budget = std::chrono::seconds{std::max(timeLimit - elapsedSeconds, 0LL)};
+        }
+        if (!deadline.isEmpty())
+        {
+            // deadline earlier than now refers to the next day
+            auto secondsToDeadline = QTime::currentTime().secsTo(parseTime(deadline));
+            if (secondsToDeadline <= 0)
+                secondsToDeadline += 24 * 60 * 60;
+            budget = std::min(budget, std::chrono::seconds{secondsToDeadline});
+        }
+        params.deadline = now + budget;
+        params.iterations = std::numeric_limits<qint64>::max();
+    }
+    params.batchSize = 1;
+    params.replicas = replicas;
+    params.batchMultiple = isAntithetic ? 2 : 1;
+    // random runs draw the seed once, it is shown to the user, so the run can be replayed
+    params.seed = seed != 0 ? seed : tools::NumberGeneratorFactory::randomSeed();
+    if (m_resume)
+    {
+        params.currentIteration = m_resume->completedIterations;
+        params.completedIterations = m_resume->completedIterations;
+        params.batchSize = m_resume->batchSize;
+        params.seed = m_resume->seed;
+        params.startTimestamp -= std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+            std::chrono::duration<double>(m_resume->elapsedSeconds));
+    }
+    std::swap(m_controlParams, params);
+    m_summary = QString("Ziarno: %1").arg(m_controlParams.seed);
+    emit summaryChanged(m_summary);
+
+    // replicas of a previous run with more threads are released, so that only the requested ones run
+    while (static_cast<int>(m_replicas.size()) > replicas)
+        releaseReplica();
+    for (int i = static_cast<int>(m_replicas.size()); i < replicas; ++i)
+    {
+        prepareReplica(i);
+    }
+
+    for (int i = 0; i < static_cast<int>(m_replicas.size()); ++i)
+    {
+        auto& replica = m_replicas[i];
+        replica.numberGenerator = std::unique_ptr<api::NumberGenerator>(tools::NumberGeneratorFactory().create(m_controlParams.seed, i, engine));
+        if (isAntithetic || stratifiedDimensions > 0)
+            replica.numberGenerator = std::make_unique<api::VarianceReductionNumberGenerator>(std::move(replica.numberGenerator), isAntithetic, stratifiedDimensions, m_controlParams.seed);
+    }
+    if (m_resume)
+    {
+        for (int i = 0; i < static_cast<int>(m_replicas.size()); ++i)
+        {
+            if (!m_replicas[i].numberGenerator->restoreState(m_resume->replicas[i].numberGenerator))
+            {
+                m_resume.reset();
+                transitionTo(ControllerState::Ready);
+                emit error(QString("Nie można odtworzyć stanu generatora liczb losowych wątku %1 z punktu kontrolnego").arg(i + 1));
+                return;
+            }
+        }
+    }
+
+    for (int i = 0; i < static_cast<int>(m_replicas.size()); ++i)
+    {
+        auto& replica = m_replicas[i];
+        auto properties = m_plugin->properties();
+        auto statistics = m_plugin->statistics();
+        if (i > 0)
+        {
+            replica.properties.reset(properties->clone());
+            replica.statistics.reset(statistics->clone());
+            properties = replica.properties.get();
+            statistics = replica.statistics.get();
+        }
+        invokeSetup(i, properties, statistics);
+    }
+}
+
+void BatchController::onSimulationReadyToRun(int replica, const api::VariableMapSnapshot& update)
+{
+    if (!isReplica(replica))
+        return;
+    auto& entry = m_replicas[replica];
+    entry.isReady = true;
+    entry.lastUpdate = update;
+    if (m_resume)
+    {
+        const auto& state = m_resume->replicas[replica];
+        invokeRestore(replica, state);
+        entry.lastUpdate = state.statistics;
+    }
+    if (std::all_of(m_replicas.begin(), m_replicas.end(), [](const auto& candidate) { return candidate.isReady; }))
+    {
+        m_resume.reset();
+        m_publisher.invalidate();
+        transitionTo(ControllerState::Running);
+        nextRun();
+    }
+}
+
+void BatchController::nextRun()
+{
+    if (m_state == ControllerState::Paused)
+    {
+        return;
+    }
+
+    if (!m_checkpointPath.isEmpty() && !m_isCheckpointPending &&
+        std::chrono::high_resolution_clock::now() - m_lastCheckpointTimestamp >= std::chrono::seconds{m_checkpointInterval})
+        m_isCheckpointPending = true;
+    if (m_isCheckpointPending)
+    {
+        // batches in flight change the state, no new batches until all replicas are idle
+        if (std::any_of(m_replicas.begin(), m_replicas.end(), [](const auto& replica) { return replica.isBusy; }))
+            return;
+        saveCheckpoint();
+    }
+
+    for (int i = 0; i < static_cast<int>(m_replicas.size()); ++i)
+    {
+        auto& replica = m_replicas[i];
+        if (!replica.isReady || replica.isBusy || m_controlParams.remainingIterations() == 0)
+            continue;
+
+        auto now = std::chrono::high_resolution_clock::now();
+        auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         now - m_controlParams.lastRunTimestamp).count();
+        if (delay < m_controlParams.minDelayBetweenRuns)
+        {
+            if (!m_isNextRunScheduled)
+            {
+                m_isNextRunScheduled = true;
+                auto diff = m_controlParams.minDelayBetweenRuns - delay;
+                QTimer::singleShot(diff, this, [this]() {
+                    m_isNextRunScheduled = false;
+                    nextRun();
+                });
+            }
+            return;
+        }
+
+        replica.isBusy = true;
+        replica.batchTimestamp = now;
+        const auto firstIteration = m_controlParams.currentIteration;
+        const int batch = m_controlParams.claimBatch();
+        replica.batchIterations = batch;
+        invokeBatch(i, replica.numberGenerator.get(), firstIteration, batch);
+    }
+
+    const auto isIdle = [](const auto& replica) { return replica.isReady && !replica.isBusy; };
+    if (m_controlParams.remainingIterations() == 0 &&
+        !m_replicas.empty() && std::all_of(m_replicas.begin(), m_replicas.end(), isIdle))
+    {
+        for (int i = 0; i < static_cast<int>(m_replicas.size()); ++i)
+        {
+            m_replicas[i].isReady = false;
+            invokeTeardown(i);
+        }
+    }
+}
+
+void BatchController::saveCheckpoint()
+{
+    m_isCheckpointPending = false;
+    m_lastCheckpointTimestamp = std::chrono::high_resolution_clock::now();
+    auto checkpoint = Checkpoint::capture(m_plugin, m_controlParams, m_replicas);
+    if (m_convergence)
+        checkpoint.convergence = m_convergence->saveState();
+    checkpoint.settings = m_runSettings;
+    try
+    {
+        checkpoint.write(m_checkpointPath);
+    }
+    catch (std::runtime_error& e)
+    {
+        // the simulation goes on, without further checkpoints
+        m_checkpointPath.clear();
+        emit error(QString::fromStdString(e.what()));
+    }
+}
+
+void BatchController::simulationStop()
+{
+    // the final state of statistics is always displayed
+    m_publisher.flush();
+    if (!m_replicas.empty() && m_controlParams.completedIterations > 0)
+    {
+        const auto seconds = m_controlParams.elapsedSeconds();
+        m_summary = QString("Wykonano %1 przebiegów w %2 s (%3 przebiegów/s), ziarno: %4")
+                        .arg(m_controlParams.completedIterations)
+                        .arg(seconds, 0, 'f', 2)
+                        .arg(seconds > 0.0 ? m_controlParams.completedIterations / seconds : 0.0, 0, 'f', 0)
+                        .arg(m_controlParams.seed);
+        if (m_convergence && std::isfinite(m_convergence->halfWidth()))
+        {
+            m_summary += QString(", %1: %2 ± %3, efektywna liczba próbek: %4")
+                             .arg(api::VariableMap(m_properties).ref<QString>("Statystyka"))
+                             .arg(m_convergence->estimate())
+                             .arg(m_convergence->halfWidth())
+                             .arg(m_convergence->effectiveSampleSize(), 0, 'f', 0);
+        }
+        emit summaryChanged(m_summary);
+    }
+    quitSimulationThread();
+    transitionTo(ControllerState::Stopped);
+}
+
+void BatchController::simulationRestart()
+{
+    m_summary.clear();
+    emit summaryChanged(m_summary);
+    prepareSimulationThread();
+    transitionTo(ControllerState::Ready);
+}
+
+bool BatchController::isSimulationExists() const
+{
+    return !m_replicas.empty() && m_replicas.front().thread->isRunning();
+}
+
+void BatchController::start()
+{
+    if (m_isBusy)
+        return;
+    m_isBusy = true;
+    if (!isSimulationExists())
+        simulationStop();
+
+    if (m_state == ControllerState::Ready)
+    {
+        simulationStart();
+    }
+    else if (m_state == ControllerState::Paused)
+    {
+        transitionTo(ControllerState::Running);
+        nextRun();
+    }
+}
+
+void BatchController::pause()
+{
+    if (m_isBusy)
+        return;
+    m_isBusy = true;
+    if (!isSimulationExists())
+        simulationStop();
+
+    if (m_state == ControllerState::Running)
+    {
+        m_publisher.flush();
+        transitionTo(ControllerState::Paused);
+    }
+}
+
+void BatchController::stop()
+{
+    if (m_isBusy)
+        return;
+    m_isBusy = true;
+    if (!isSimulationExists())
+        simulationStop();
+
+    if (m_state == ControllerState::Running || m_state == ControllerState::Paused)
+    {
+        simulationStop();
+    }
+}
+
+void BatchController::restart()
+{
+    if (m_isBusy)
+        return;
+    m_isBusy = true;
+
+    simulationRestart();
+}
+
+}  // namespace controllers
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <QObject>
+#include <QQmlEngine>
+#include <QThread>
+#include <chrono>
+#include <optional>
+#include <vector>
+
+#include "icontroller.hpp"
+#include "replica.hpp"
+#include "simulationcontrolparams.hpp"
+#include "statisticsmerger.hpp"
+#include "convergencemonitor.hpp"
+#include "checkpoint.hpp"
+#include "statisticspublisher.hpp"
+#include "providers/statistics.hpp"
+#include "ControllerState.hpp"
+
+
+namespace api
+{
+class ISimulationDLL;
+class ISimulation;
+class NumberGenerator;
+}  // namespace api
+
+
+namespace controllers
+{
+
+/**
+ * @brief The BatchController class
+ * Common part of controllers running the simulation in batches of iterations
+ * on parallel replicas. It defines the properties of the run, dispatches batches,
+ * merges and publishes statistics, monitors convergence, keeps the time budget
+ * and saves checkpoints. Derived controllers invoke the lifecycle methods
+ * of their type of simulation and present its output.
+ * Constructors of derived controllers call prepareSimulationThread().
+ */
+class BatchController : public IController
+{
+    Q_OBJECT
+
+    Q_PROPERTY(ControllerState::State state READ state NOTIFY stateChanged)
+    Q_PROPERTY(QString summary READ summary NOTIFY summaryChanged)
+
+public:
+    BatchController(api::ISimulationDLL* plugin,
+                    QObject* parent = nullptr);
+    ~BatchController();
+
+    Q_INVOKABLE void start();
+    Q_INVOKABLE void pause();
+    Q_INVOKABLE void stop();
+    Q_INVOKABLE void restart();
+
+    api::Variables properties() override;
+    providers::IProvider* statistics() override;
+
+    ControllerState::State state() const;
+    QString summary() const;
+
+signals:
+    void stateChanged(ControllerState::State state); // clazy:exclude=fully-qualified-moc-types
+    void error(const QString& message);
+    void summaryChanged(const QString& summary);
+
+protected:
+    /**
+     * @brief bindSignals
+     * Connects the lifecycle signals of the simulation to onSimulationReadyToRun(),
+     * onSimulationRunFinished() and onSimulationTeardownFinished()
+     */
+    virtual void bindSignals(api::ISimulation* simulation, int replica) = 0;
+
+    // queued on the thread of the replica
+    virtual void invokeSetup(int replica, api::Variables properties, api::Variables statistics) = 0;
+    virtual void invokeBatch(int replica, api::NumberGenerator* generator, qint64 firstIteration, qint64 iterations) = 0;
+    virtual void invokeTeardown(int replica) = 0;
+
+    // blocks until the replica restored the state
+    virtual void invokeRestore(int replica, const Checkpoint::ReplicaState& state) = 0;
+
+    void prepareSimulationThread();
+    bool isReplica(int replica) const;
+    api::ISimulation* simulation(int replica) const;
+
+    void onSimulationReadyToRun(int replica, const api::VariableMapSnapshot& update);
+    void onSimulationRunFinished(int replica, const api::VariableMapSnapshot& update);
+    void onSimulationTeardownFinished(int replica);
+
+private slots:
+    void onSimulationUpdateProgress(int replica, const api::VariableMapSnapshot& update);
+    void onSimulationError(const QString& message);
+
+private:
+    void prepareReplica(int replica);
+    void releaseReplica();
+    void quitSimulationThread();
+    bool isSimulationExists() const;
+    void nextRun();
+    void saveCheckpoint();
+    std::optional<api::VariableMapSnapshot> collectStatistics();
+    std::optional<api::VariableMapSnapshot> publishStatistics();
+
+    void simulationStart();
+    void simulationStop();
+    void simulationRestart();
+
+    void transitionTo(ControllerState::State state);
+
+private:
+    api::ISimulationDLL* m_plugin;
+    providers::Statistics m_statistics;
+    api::Variables m_properties;
+    std::vector<Replica> m_replicas;
+    std::unique_ptr<StatisticsMerger> m_merger;
+    std::optional<ConvergenceMonitor> m_convergence;
+    std::optional<Checkpoint> m_resume;
+    Checkpoint::Settings m_runSettings;
+    QString m_checkpointPath;
+    std::chrono::time_point<std::chrono::high_resolution_clock> m_lastCheckpointTimestamp;
+    ControllerState::State m_state;
+    QString m_summary;
+    bool m_isBusy;
+    bool m_isNextRunScheduled;
+    bool m_isCheckpointPending;
+    int m_checkpointInterval;
+    SimulationControlParams m_controlParams;
+    StatisticsPublisher m_publisher;
+};
+
+}  // namespace controllers
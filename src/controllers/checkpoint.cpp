@@ -0,0 +1,89 @@
+#include "checkpoint.hpp"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+#include <stdexcept>
+
+
+namespace controllers
+{
+
+Checkpoint Checkpoint::capture(api::ISimulationDLL* plugin,
+                               const SimulationControlParams& params,
+                               const std::vector<Replica>& replicas)
+{
+    auto checkpoint = Checkpoint{};
+    checkpoint.simulation = plugin->name();
+    checkpoint.properties = api::VariableMap(plugin->properties()).snapshot();
+    checkpoint.seed = params.seed;
+    checkpoint.completedIterations = params.completedIterations;
+    checkpoint.batchSize = params.batchSize;
+    checkpoint.elapsedSeconds = params.elapsedSeconds();
+    for (const auto& replica : replicas)
+    {
+        auto& state = checkpoint.replicas.emplace_back();
+        state.numberGenerator = replica.numberGenerator->saveState();
+        if (replica.lastUpdate)
+            state.statistics = *replica.lastUpdate;
+        auto simulation = replica.simulation;
+        QMetaObject::invokeMethod(simulation, [simulation, &state]() { state.simulation = simulation->saveState(); },
+                                  Qt::BlockingQueuedConnection);
+    }
+    return checkpoint;
+}
+
+void Checkpoint::write(const QString& path) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        throw std::runtime_error{QString("Nie można zapisać punktu kontrolnego '%1':\n%2").arg(path, file.errorString()).toStdString()};
+
+    QDataStream stream(&file);
+    stream << magic << version;
+    stream.setVersion(QDataStream::Qt_6_8);
+    stream << simulation << properties << seed << completedIterations << batchSize << elapsedSeconds << convergence;
+    stream << settings.generator << settings.isAntithetic << settings.stratifiedDimensions
+           << settings.iterations << settings.timeLimit << settings.deadline;
+    stream << static_cast<quint32>(replicas.size());
+    for (const auto& replica : replicas)
+    {
+        stream << replica.numberGenerator << replica.statistics << replica.simulation;
+    }
+
+    if (stream.status() != QDataStream::Ok || !file.commit())
+        throw std::runtime_error{QString("Nie można zapisać punktu kontrolnego '%1':\n%2").arg(path, file.errorString()).toStdString()};
+}
+
+Checkpoint Checkpoint::read(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        throw std::runtime_error{QString("Nie można odczytać punktu kontrolnego '%1':\n%2").arg(path, file.errorString()).toStdString()};
+
+    QDataStream stream(&file);
+    quint32 fileMagic = 0;
+    quint32 fileVersion = 0;
+    stream >> fileMagic >> fileVersion;
+    if (fileMagic != magic || fileVersion != version)
+        throw std::runtime_error{QString("Plik '%1' nie jest obsługiwanym punktem kontrolnym").arg(path).toStdString()};
+    stream.setVersion(QDataStream::Qt_6_8);
+
+    auto checkpoint = Checkpoint{};
+    quint32 replicas = 0;
+    stream >> checkpoint.simulation >> checkpoint.properties >> checkpoint.seed >> checkpoint.completedIterations
+           >> checkpoint.batchSize >> checkpoint.elapsedSeconds >> checkpoint.convergence;
+    stream >> checkpoint.settings.generator >> checkpoint.settings.isAntithetic >> checkpoint.settings.stratifiedDimensions
+           >> checkpoint.settings.iterations >> checkpoint.settings.timeLimit >> checkpoint.settings.deadline >> replicas;
+    for (quint32 i = 0; i < replicas && stream.status() == QDataStream::Ok; ++i)
+    {
+        auto& replica = checkpoint.replicas.emplace_back();
+        stream >> replica.numberGenerator >> replica.statistics >> replica.simulation;
+    }
+
+    if (stream.status() != QDataStream::Ok || checkpoint.replicas.isEmpty())
+        throw std::runtime_error{QString("Punkt kontrolny '%1' jest uszkodzony").arg(path).toStdString()};
+    return checkpoint;
+}
+
+}  // namespace controllers
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <vector>
+
+#include "api/simulation.hpp"
+#include "replica.hpp"
+#include "simulationcontrolparams.hpp"
+
+
+namespace controllers
+{
+
+/**
+ * @brief The Checkpoint struct
+ * State of a running simulation saved between batches, which allows resuming
+ * the simulation after the application is closed. Every replica keeps the state
+ * of its random numbers, its statistics and an optional state of the plugin,
+ * so the resumed simulation continues with the same results as if it never stopped.
+ * Settings of the run which change the random numbers or the course of the run
+ * are saved as well and replace the settings of the controller on resume.
+ * The file is written atomically, a crash during writing keeps the previous checkpoint.
+ */
+struct Checkpoint
+{
+    struct ReplicaState
+    {
+        QByteArray numberGenerator;
+        api::VariableMapSnapshot statistics;
+        QByteArray simulation;
+    };
+
+    struct Settings
+    {
+        QString generator;
+        bool isAntithetic = false;
+        int stratifiedDimensions = 0;
+        qint64 iterations = 0;
+        int timeLimit = 0;
+        QString deadline;
+    };
+
+    static constexpr quint32 magic = 0x534d434b;  // "SMCK"
+    static constexpr quint32 version = 7;
+
+    QString simulation;
+    api::VariableMapSnapshot properties;
+    int seed = 0;
+    qint64 completedIterations = 0;
+    int batchSize = 1;
+    double elapsedSeconds = 0.0;
+    QByteArray convergence;
+    Settings settings;
+    QList<ReplicaState> replicas;
+
+    /**
+     * @brief capture
+     * Collects the state of idle replicas, plugin objects are asked
+     * for their state on their own threads
+     */
+    static Checkpoint capture(api::ISimulationDLL* plugin,
+                              const SimulationControlParams& params,
+                              const std::vector<Replica>& replicas);
+
+    /**
+     * @brief write
+     * @throws std::runtime_error if the file cannot be written
+     */
+    void write(const QString& path) const;
+
+    /**
+     * @brief read
+     * @throws std::runtime_error if the file cannot be read or is not a valid checkpoint
+     */
+    static Checkpoint read(const QString& path);
+};
+
+}  // namespace controllers
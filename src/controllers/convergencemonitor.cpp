@@ -0,0 +1,201 @@
+#include "convergencemonitor.hpp"
+
+#include <QDataStream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+
+namespace controllers
+{
+
+ConvergenceMonitor::ConvergenceMonitor(api::Variables statistics, const QString& statistic, double halfWidth, double confidence)
+    : m_statistic{statistic}
+    , m_targetHalfWidth{halfWidth}
+    , m_z{quantile(confidence)}
+    , m_controlExpectedMean{0.0}
+    , m_controlEstimate{0.0}
+    , m_estimate{0.0}
+    , m_iterations{0}
+    , m_batches{0}
+    , m_weights{0.0}
+    , m_weightedMeans{0.0}
+    , m_weightedSquares{0.0}
+    , m_weightedControlMeans{0.0}
+    , m_weightedControlSquares{0.0}
+    , m_weightedProducts{0.0}
+    , m_sampleVariance{std::numeric_limits<double>::quiet_NaN()}
+{
+    auto statisticsMap = api::VariableMap(statistics);
+    m_watchList = statisticsMap.watch();
+    checkStatistic(m_statistic);
+}
+
+void ConvergenceMonitor::setControlVariate(const QString& statistic, double expectedMean)
+{
+    checkStatistic(statistic);
+    if (statistic == m_statistic)
+        throw std::runtime_error{QString("Zmienna kontrolna '%1' musi być inną statystyką niż obserwowana").arg(statistic).toStdString()};
+    m_control = statistic;
+    m_controlExpectedMean = expectedMean;
+}
+
+bool ConvergenceMonitor::hasControlVariate() const
+{
+    return !m_control.isEmpty();
+}
+
+void ConvergenceMonitor::update(const api::VariableMapSnapshot& snapshot, qint64 iterations)
+{
+    if (iterations <= m_iterations)
+        return;
+    m_watchList->update(snapshot);
+    const auto value = (*m_watchList)[m_statistic];
+    const auto estimate = value.toDouble();
+    if (value.metaType() == QMetaType::fromType<api::accumulator::Mean>())
+    {
+        // samples spread over iterations, scaled to the variance of the mean of a single iteration
+        const auto samples = value.value<api::accumulator::Mean>();
+        if (samples.count() > 1)
+            m_sampleVariance = samples.variance() * static_cast<double>(iterations) / static_cast<double>(samples.count());
+    }
+
+    // running mean after the batch minus its part from previous batches
+    const auto size = static_cast<double>(iterations - m_iterations);
+    const auto batchMean = (estimate * static_cast<double>(iterations) - m_estimate * static_cast<double>(m_iterations)) / size;
+    m_weights += size;
+    m_weightedMeans += size * batchMean;
+    m_weightedSquares += size * batchMean * batchMean;
+    ++m_batches;
+
+    if (hasControlVariate())
+    {
+        const auto controlEstimate = (*m_watchList)[m_control].toDouble();
+        const auto controlBatchMean =
+            (controlEstimate * static_cast<double>(iterations) - m_controlEstimate * static_cast<double>(m_iterations)) / size;
+        m_weightedControlMeans += size * controlBatchMean;
+        m_weightedControlSquares += size * controlBatchMean * controlBatchMean;
+        m_weightedProducts += size * batchMean * controlBatchMean;
+        m_controlEstimate = controlEstimate;
+    }
+
+    m_estimate = estimate;
+    m_iterations = iterations;
+}
+
+int ConvergenceMonitor::batches() const
+{
+    return m_batches;
+}
+
+double ConvergenceMonitor::estimate() const
+{
+    if (!hasControlVariate() || controlDeviations() <= 0.0)
+        return m_estimate;
+    // regression coefficient of the statistic on the control
+    const auto beta = productDeviations() / controlDeviations();
+    return m_estimate - beta * (m_controlEstimate - m_controlExpectedMean);
+}
+
+double ConvergenceMonitor::standardError() const
+{
+    // the regression coefficient costs one more degree of freedom
+    const auto degreesOfFreedom = hasControlVariate() ? m_batches - 2 : m_batches - 1;
+    if (degreesOfFreedom < 1)
+        return std::numeric_limits<double>::infinity();
+    // sum of n * (mean - estimate)^2 estimates the variance of a single iteration
+    const auto variance = std::max(residualDeviations(), 0.0) / degreesOfFreedom;
+    return std::sqrt(variance / static_cast<double>(m_iterations));
+}
+
+double ConvergenceMonitor::halfWidth() const
+{
+    return m_z * standardError();
+}
+
+bool ConvergenceMonitor::isConverged() const
+{
+    return m_batches >= minBatches && halfWidth() <= m_targetHalfWidth;
+}
+
+double ConvergenceMonitor::effectiveSampleSize() const
+{
+    const auto error = standardError();
+    if (!std::isfinite(error) || error <= 0.0)
+        return static_cast<double>(m_iterations);
+    auto variance = m_sampleVariance;
+    if (!std::isfinite(variance))
+        variance = std::max(deviations(), 0.0) / (m_batches - 1);
+    // per-sample variance over the squared standard error of batch means
+    return variance / (error * error);
+}
+
+QByteArray ConvergenceMonitor::saveState() const
+{
+    QByteArray state;
+    QDataStream stream(&state, QIODevice::WriteOnly);
+    stream << m_estimate << m_iterations << m_batches << m_weights << m_weightedMeans << m_weightedSquares;
+    stream << m_controlEstimate << m_weightedControlMeans << m_weightedControlSquares << m_weightedProducts;
+    return state;
+}
+
+void ConvergenceMonitor::restoreState(const QByteArray& state)
+{
+    QDataStream stream(state);
+    stream >> m_estimate >> m_iterations >> m_batches >> m_weights >> m_weightedMeans >> m_weightedSquares;
+    stream >> m_controlEstimate >> m_weightedControlMeans >> m_weightedControlSquares >> m_weightedProducts;
+}
+
+void ConvergenceMonitor::checkStatistic(const QString& statistic) const
+{
+    if (!m_watchList->contains(statistic))
+        throw std::runtime_error{QString("Statystyka '%1' nie istnieje").arg(statistic).toStdString()};
+    bool ok = false;
+    (*m_watchList)[statistic].toDouble(&ok);
+    if (!ok)
+        throw std::runtime_error{QString("Statystyka '%1' nie jest liczbą").arg(statistic).toStdString()};
+}
+
+double ConvergenceMonitor::deviations() const
+{
+    return m_weightedSquares - 2.0 * m_estimate * m_weightedMeans + m_estimate * m_estimate * m_weights;
+}
+
+double ConvergenceMonitor::controlDeviations() const
+{
+    return m_weightedControlSquares - 2.0 * m_controlEstimate * m_weightedControlMeans + m_controlEstimate * m_controlEstimate * m_weights;
+}
+
+double ConvergenceMonitor::productDeviations() const
+{
+    return m_weightedProducts - m_controlEstimate * m_weightedMeans - m_estimate * m_weightedControlMeans
+           + m_estimate * m_controlEstimate * m_weights;
+}
+
+double ConvergenceMonitor::residualDeviations() const
+{
+    const auto control = controlDeviations();
+    if (!hasControlVariate() || control <= 0.0)
+        return deviations();
+    const auto product = productDeviations();
+    return deviations() - product * product / control;
+}
+
+double ConvergenceMonitor::quantile(double confidence)
+{
+    // bisection on P(|Z| <= z) = erf(z / sqrt(2))
+    double low = 0.0;
+    double high = 40.0;
+    for (int i = 0; i < 100; ++i)
+    {
+        const auto middle = (low + high) / 2.0;
+        if (std::erf(middle / std::sqrt(2.0)) < confidence)
+            low = middle;
+        else
+            high = middle;
+    }
+    return (low + high) / 2.0;
+}
+
+}  // namespace controllers
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <optional>
+
+#include "api/simulation.hpp"
+
+
+namespace controllers
+{
+
+/**
+ * @brief The ConvergenceMonitor class
+ * Decides when the estimate of a statistic is accurate enough to stop the simulation.
+ * The statistic is treated as a running mean over iterations, so the mean of every
+ * finished batch can be recovered from two consecutive snapshots. The standard error
+ * is estimated from these batch means, weighted by batch sizes (method of batch means),
+ * and the simulation is converged once the confidence interval is narrow enough.
+ * With a control variate, a second statistic of the known expected value, the estimate
+ * is corrected by the regression of batch means of the statistic on the control,
+ * which removes the part of the variance explained by the control.
+ * The effective sample size compares the standard error with the variance of a plain iteration,
+ * so it shows the gain of every variance reduction, antithetic and stratified runs included.
+ */
+class ConvergenceMonitor
+{
+public:
+    static constexpr int minBatches = 20;
+
+public:
+    /**
+     * @brief ConvergenceMonitor
+     * @param statistics statistics of the simulation, used to find the watched statistic
+     * @param statistic name of the numeric statistic
+     * @param halfWidth target half-width of the confidence interval
+     * @param confidence confidence level of the interval in range (0, 1)
+     * @throws std::runtime_error if the statistic does not exist or is not numeric
+     */
+    ConvergenceMonitor(api::Variables statistics, const QString& statistic, double halfWidth, double confidence);
+
+    /**
+     * @brief update
+     * @param snapshot statistics after `iterations` finished iterations
+     * @param iterations number of all finished iterations
+     */
+    void update(const api::VariableMapSnapshot& snapshot, qint64 iterations);
+
+    /**
+     * @brief setControlVariate
+     * Must be called before the first update()
+     * @param statistic name of the numeric statistic correlated with the watched one
+     * @param expectedMean exact expected value of the control statistic
+     * @throws std::runtime_error if the statistic does not exist or is not numeric
+     */
+    void setControlVariate(const QString& statistic, double expectedMean);
+    bool hasControlVariate() const;
+
+    int batches() const;
+    double estimate() const;
+    double standardError() const;
+    double halfWidth() const;
+    bool isConverged() const;
+
+    /**
+     * @brief effectiveSampleSize
+     * The variance of a plain iteration is taken from samples of a Mean statistic. Other statistics
+     * estimate it from batch means, which already include the reduction inside batches,
+     * so only the control variate is credited for them.
+     * @return number of plain iterations giving the same standard error as the estimate
+     */
+    double effectiveSampleSize() const;
+
+    /**
+     * @brief saveState
+     * @return accumulated batch means, used by checkpoints
+     */
+    QByteArray saveState() const;
+    void restoreState(const QByteArray& state);
+
+    /**
+     * @brief quantile
+     * @return z such that the standard normal variable falls into [-z, z] with the probability `confidence`
+     */
+    static double quantile(double confidence);
+
+private:
+    QString m_statistic;
+    double m_targetHalfWidth;
+    double m_z;
+    std::optional<api::VariableWatchList> m_watchList;
+    QString m_control;
+    double m_controlExpectedMean;
+    double m_controlEstimate;
+    double m_estimate;
+    qint64 m_iterations;
+    int m_batches;
+    // sums of batch sizes n, n * mean and n * mean^2
+    double m_weights;
+    double m_weightedMeans;
+    double m_weightedSquares;
+    // sums of n * control mean, n * control mean^2 and n * mean * control mean
+    double m_weightedControlMeans;
+    double m_weightedControlSquares;
+    double m_weightedProducts;
+    // variance of a plain iteration measured by a Mean statistic, NaN for other statistics
+    double m_sampleVariance;
+
+private:
+    void checkStatistic(const QString& statistic) const;
+    // sums of squared deviations and products of deviations of batch means, weighted by batch sizes
+    double deviations() const;
+    double controlDeviations() const;
+    double productDeviations() const;
+    double residualDeviations() const;
+};
+
+}  // namespace controllers
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QThread>
+#include <chrono>
+#include <memory>
+#include <optional>
+
+#include "api/simulation.hpp"
+
+
+namespace controllers
+{
+
+/**
+ * @brief The Replica struct
+ * Single instance of the simulation, running on its own thread.
+ * Parallel runs use many replicas, each with an independent stream
+ * of random numbers and its own copy of properties and statistics.
+ * The first replica works directly on the plugin variables.
+ */
+struct Replica
+{
+    QThread* thread = nullptr;
+    api::ISimulation* simulation = nullptr;
+    std::unique_ptr<api::NumberGenerator> numberGenerator;
+    std::unique_ptr<api::IVariable> properties;
+    std::unique_ptr<api::IVariable> statistics;
+    std::optional<api::VariableMapSnapshot> lastUpdate;
+    std::chrono::time_point<std::chrono::high_resolution_clock> batchTimestamp;
+    int batchIterations = 0;
+    bool isReady = false;
+    bool isBusy = false;
+    bool isFinished = false;
+};
+
+}  // namespace controllers
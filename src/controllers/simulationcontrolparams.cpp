@@ -0,0 +1,64 @@
+#include "simulationcontrolparams.hpp"
+
+#include <algorithm>
+
+
+namespace controllers
+{
+
+qint64 SimulationControlParams::remainingIterations() const
+{
+    if (deadline && Clock::now() >= *deadline)
+        return 0;
+    return std::max(iterations - currentIteration, qint64{0});
+}
+
+int SimulationControlParams::claimBatch()
+{
+    // delay between runs is defined per iteration, pace them one by one
+    int batch = minDelayBetweenRuns > 0
+                    ? 1
+                    : static_cast<int>(std::clamp<qint64>(batchSize, 1, std::max(remainingIterations(), qint64{1})));
+    // the last batches before the deadline take only the remaining time
+    if (deadline && iterationsPerSecond > 0.0)
+    {
+        const auto remainingSeconds = std::chrono::duration<double>(*deadline - Clock::now()).count();
+        const auto fitting = std::min(iterationsPerSecond * remainingSeconds, static_cast<double>(batch));
+        batch = std::max(static_cast<int>(fitting), 1);
+    }
+    // paced iterations run one by one, the partner of an antithetic pair follows in the next batch
+    if (batchMultiple > 1 && minDelayBetweenRuns <= 0)
+        batch = std::max(batch - batch % batchMultiple, batchMultiple);
+    // rounding never runs more iterations than requested
+    batch = static_cast<int>(std::min<qint64>(batch, std::max(remainingIterations(), qint64{1})));
+    currentIteration += batch;
+    lastRunTimestamp = Clock::now();
+    return batch;
+}
+
+void SimulationControlParams::batchFinished(Clock::duration duration, int iterations)
+{
+    const auto seconds = std::chrono::duration<double>(duration).count();
+    if (seconds > 0.0)
+    {
+        const auto rate = iterations / seconds;
+        iterationsPerSecond = iterationsPerSecond > 0.0 ? (iterationsPerSecond + rate) / 2.0 : rate;
+    }
+
+    if (duration < targetBatchDuration / 2)
+        batchSize = std::min(batchSize * 2, maxBatchSize);
+    else if (duration > targetBatchDuration * 2)
+        batchSize = std::max(batchSize / 2, 1);
+}
+
+void SimulationControlParams::finish()
+{
+    iterations = std::min(iterations, currentIteration);
+}
+
+double SimulationControlParams::elapsedSeconds() const
+{
+    return std::chrono::duration<double>(Clock::now() - startTimestamp).count();
+}
+
+}  // namespace controllers
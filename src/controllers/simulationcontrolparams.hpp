@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QtGlobal>
+#include <chrono>
+#include <optional>
+
+
+namespace controllers
+{
+
+/**
+ * @brief The SimulationControlParams struct
+ * Describes the course of a single simulation started by a controller.
+ * Iterations are dispatched to the simulation thread in batches,
+ * the batch size adapts to the measured duration of previous batches,
+ * so that the controller gets back control about once per frame.
+ * Parallel replicas claim batches from the same pool of iterations.
+ * With a deadline the simulation runs as many iterations as fit in the time,
+ * batches are shortened so that they do not overrun the deadline.
+ * Batches start at multiples of batchMultiple, which keeps antithetic pairs together,
+ * except the last batch of an odd number of iterations and paced runs.
+ */
+struct SimulationControlParams
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    static constexpr auto targetBatchDuration = std::chrono::milliseconds{16};
+    static constexpr int maxBatchSize = 1 << 20;
+
+    std::chrono::time_point<Clock> startTimestamp;
+    std::chrono::time_point<Clock> lastRunTimestamp;
+    std::optional<std::chrono::time_point<Clock>> deadline;
+    double iterationsPerSecond;  // measured throughput of a single replica
+    int minDelayBetweenRuns;
+    qint64 currentIteration;
+    qint64 completedIterations;
+    qint64 iterations;
+    int batchSize;
+    int replicas;
+    int batchMultiple;  // batches are multiples of it, antithetic pairs stay in one batch
+    int seed;  // seed actually used, drawn from entropy for random runs
+
+    qint64 remainingIterations() const;
+
+    /**
+     * @brief claimBatch
+     * Marks the next batch of iterations as dispatched
+     * @return number of iterations to execute in the batch
+     */
+    int claimBatch();
+
+    /**
+     * @brief batchFinished
+     * Adapts the batch size to the duration of the last batch
+     * @param duration time between the batch dispatch and receiving its result
+     * @param iterations number of iterations executed in the batch
+     */
+    void batchFinished(Clock::duration duration, int iterations);
+
+    /**
+     * @brief finish
+     * Stops claiming new batches, batches already dispatched are still completed
+     */
+    void finish();
+
+    /**
+     * @brief elapsedSeconds
+     * @return wall-clock time since the start of the simulation
+     */
+    double elapsedSeconds() const;
+};
+
+}  // namespace controllers
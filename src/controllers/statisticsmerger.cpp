@@ -0,0 +1,53 @@
+#include "statisticsmerger.hpp"
+
+
+namespace controllers
+{
+
+StatisticsMerger::StatisticsMerger(api::ISimulationDLL* plugin)
+    : m_plugin{plugin}
+    , m_totalStatistics{plugin->statistics()->clone()}
+    , m_partialStatistics{plugin->statistics()->clone()}
+    , m_total{m_totalStatistics.get()}
+    , m_isSupported{false}
+{
+    auto partial = api::VariableMap(m_partialStatistics.get());
+    partial.reset();
+    m_partial = partial.watch();
+
+    // merging default statistics checks whether the plugin supports merging at all
+    m_total.reset();
+    m_isSupported = m_plugin->merge(m_total, *m_partial);
+}
+
+bool StatisticsMerger::isSupported() const
+{
+    return m_isSupported;
+}
+
+api::VariableMapSnapshot StatisticsMerger::merge(const std::vector<Replica>& replicas)
+{
+    m_total.reset();
+    for (const auto& replica : replicas)
+    {
+        if (replica.lastUpdate)
+        {
+            m_partial->update(*replica.lastUpdate);
+            m_plugin->merge(m_total, *m_partial);
+        }
+    }
+    return m_total.snapshot();
+}
+
+api::VariableMapSnapshot StatisticsMerger::merge(const std::vector<api::VariableMapSnapshot>& snapshots)
+{
+    m_total.reset();
+    for (const auto& snapshot : snapshots)
+    {
+        m_partial->update(snapshot);
+        m_plugin->merge(m_total, *m_partial);
+    }
+    return m_total.snapshot();
+}
+
+}  // namespace controllers
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "replica.hpp"
+
+
+namespace controllers
+{
+
+/**
+ * @brief The StatisticsMerger class
+ * Combines the last statistics reported by all replicas
+ * into a single snapshot, using ISimulationDLL::merge()
+ */
+class StatisticsMerger
+{
+public:
+    explicit StatisticsMerger(api::ISimulationDLL* plugin);
+
+    bool isSupported() const;
+    api::VariableMapSnapshot merge(const std::vector<Replica>& replicas);
+    api::VariableMapSnapshot merge(const std::vector<api::VariableMapSnapshot>& snapshots);
+
+private:
+    api::ISimulationDLL* m_plugin;
+    std::unique_ptr<api::IVariable> m_totalStatistics;
+    std::unique_ptr<api::IVariable> m_partialStatistics;
+    api::VariableMap m_total;
+    std::optional<api::VariableWatchList> m_partial;
+    bool m_isSupported;
+};
+
+}  // namespace controllers
@@ -0,0 +1,51 @@
+#include "statisticspublisher.hpp"
+
+
+namespace controllers
+{
+
+StatisticsPublisher::StatisticsPublisher(providers::Statistics* statistics, Source source, QObject* parent)
+    : QObject(parent)
+    , m_statistics{statistics}
+    , m_source{std::move(source)}
+    , m_isPending{false}
+{
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(defaultInterval);
+    // pending statistics of the interval are published at its end
+    QObject::connect(&m_timer, &QTimer::timeout, this, [this]() {
+        if (m_isPending)
+            publish();
+    });
+}
+
+void StatisticsPublisher::setInterval(int milliseconds)
+{
+    m_timer.setInterval(milliseconds);
+}
+
+void StatisticsPublisher::invalidate()
+{
+    m_isPending = true;
+    // first report after a quiet period is published without waiting
+    if (!m_timer.isActive())
+        publish();
+}
+
+void StatisticsPublisher::flush()
+{
+    m_timer.stop();
+    if (m_isPending)
+        publish();
+}
+
+void StatisticsPublisher::publish()
+{
+    m_isPending = false;
+    if (auto snapshot = m_source())
+        m_statistics->updateWatched(*snapshot);
+    if (m_timer.interval() > 0)
+        m_timer.start();
+}
+
+}  // namespace controllers
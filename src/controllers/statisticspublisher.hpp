@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <functional>
+#include <optional>
+
+#include "api/variable.hpp"
+#include "providers/statistics.hpp"
+
+
+namespace controllers
+{
+
+/**
+ * @brief The StatisticsPublisher class
+ * Limits how often statistics reach the user interface.
+ * Simulations report statistics after every batch or on progress,
+ * the publisher coalesces these reports and updates the statistics provider
+ * at most once per interval (by default once per frame). Statistics are
+ * collected only when they are published, so merging replicas costs nothing
+ * for reports that would never be seen. The last report is always delivered.
+ */
+class StatisticsPublisher : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Source = std::function<std::optional<api::VariableMapSnapshot>()>;
+
+    static constexpr int defaultInterval = 16;
+
+public:
+    StatisticsPublisher(providers::Statistics* statistics, Source source, QObject* parent = nullptr);
+
+    /**
+     * @brief setInterval
+     * @param milliseconds minimal time between updates, 0 publishes every report
+     */
+    void setInterval(int milliseconds);
+
+    /**
+     * @brief invalidate
+     * Reports new statistics, they are published now or when the interval elapses
+     */
+    void invalidate();
+
+    /**
+     * @brief flush
+     * Publishes pending statistics immediately
+     */
+    void flush();
+
+private:
+    void publish();
+
+private:
+    providers::Statistics* m_statistics;
+    Source m_source;
+    QTimer m_timer;
+    bool m_isPending;
+};
+
+}  // namespace controllers
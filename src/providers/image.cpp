@@ -1,7 +1,206 @@
 #include "image.hpp"
 
+#include <QSGGeometryNode>
+#include <QSGRendererInterface>
 #include <QSGSimpleTextureNode>
+#include <QSGTexture>
+#include <QSGTransformNode>
+#include <QSGVertexColorMaterial>
 #include <QQuickWindow>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <utility>
+#include <rhi/qrhi.h>
+
+
+namespace
+{
+
+/**
+ * Chunk of points with the vertex buffer allocated for ImageProvider::pointsPerChunk points,
+ * unused vertices are transparent, so appending points does not reallocate the buffer
+ */
+class PointsNode : public QSGGeometryNode
+{
+public:
+    PointsNode()
+        : m_geometry{QSGGeometry::defaultAttributes_ColoredPoint2D(), ImageProvider::pointsPerChunk}
+    {
+        m_geometry.setDrawingMode(QSGGeometry::DrawPoints);
+        m_geometry.setVertexDataPattern(QSGGeometry::DynamicPattern);
+        std::fill_n(m_geometry.vertexDataAsColoredPoint2D(), ImageProvider::pointsPerChunk, QSGGeometry::ColoredPoint2D{});
+        setGeometry(&m_geometry);
+        setMaterial(&m_material);
+    }
+
+    int size() const { return m_size; }
+    bool isFull() const { return m_size == ImageProvider::pointsPerChunk; }
+
+    /**
+     * @brief append
+     * @return number of points taken from the range
+     */
+    int append(const api::Point* points, int count)
+    {
+        const auto taken = std::min(count, ImageProvider::pointsPerChunk - m_size);
+        auto* vertices = m_geometry.vertexDataAsColoredPoint2D() + m_size;
+        for (int i = 0; i < taken; ++i)
+        {
+            const auto color = qPremultiply(points[i].color);
+            vertices[i].set(points[i].x, points[i].y, qRed(color), qGreen(color), qBlue(color), qAlpha(color));
+        }
+        m_size += taken;
+        // full chunks are uploaded once more and never change again
+        if (isFull())
+            m_geometry.setVertexDataPattern(QSGGeometry::StaticPattern);
+        m_geometry.markVertexDataDirty();
+        markDirty(QSGNode::DirtyGeometry);
+        return taken;
+    }
+
+private:
+    QSGGeometry m_geometry;
+    QSGVertexColorMaterial m_material;
+    int m_size = 0;
+};
+
+/**
+ * Texture of the whole image kept between frames, a new image is uploaded only
+ * in the changed rectangles. Uploads are recorded when the scene graph commits
+ * operations of the texture, so they go with the resource updates of the frame.
+ */
+class ImageTexture : public QSGTexture
+{
+public:
+    explicit ImageTexture(const QImage& image)
+        : m_image{image.convertToFormat(QImage::Format_ARGB32_Premultiplied)}
+    {
+    }
+
+    ~ImageTexture() override
+    {
+        if (m_texture)
+            m_texture->deleteLater();
+    }
+
+    /**
+     * @brief update
+     * @param image new image of the same size
+     * @param dirtyRects changed parts of the image, empty to upload the whole image
+     */
+    void update(const QImage& image, const QList<QRect>& dirtyRects)
+    {
+        m_image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        if (dirtyRects.isEmpty())
+            m_isFullUploadPending = true;
+        // images not rendered yet accumulate their changes
+        for (const auto& rect : dirtyRects)
+        {
+            if (!m_isFullUploadPending && !m_pendingRects.contains(rect))
+                m_pendingRects.append(rect);
+        }
+        if (m_isFullUploadPending)
+            m_pendingRects.clear();
+    }
+
+    qint64 comparisonKey() const override { return static_cast<qint64>(reinterpret_cast<quintptr>(this)); }
+    QRhiTexture* rhiTexture() const override { return m_texture; }
+    QSize textureSize() const override { return m_image.size(); }
+    bool hasAlphaChannel() const override { return m_image.hasAlphaChannel(); }
+    bool hasMipmaps() const override { return false; }
+
+    void commitTextureOperations(QRhi* rhi, QRhiResourceUpdateBatch* resourceUpdates) override
+    {
+        if (!m_texture)
+        {
+            m_format = rhi->isTextureFormatSupported(QRhiTexture::BGRA8) ? QRhiTexture::BGRA8 : QRhiTexture::RGBA8;
+            m_texture = rhi->newTexture(m_format, m_image.size());
+            if (!m_texture->create())
+            {
+                delete m_texture;
+                m_texture = nullptr;
+                return;
+            }
+            m_isFullUploadPending = true;
+        }
+        if (!m_isFullUploadPending && m_pendingRects.isEmpty())
+            return;
+
+        QList<QRhiTextureUploadEntry> entries;
+        if (m_isFullUploadPending)
+            entries.append(QRhiTextureUploadEntry(0, 0, subresource(m_image.rect())));
+        for (const auto& rect : std::as_const(m_pendingRects))
+            entries.append(QRhiTextureUploadEntry(0, 0, subresource(rect)));
+        QRhiTextureUploadDescription upload;
+        upload.setEntries(entries.cbegin(), entries.cend());
+        resourceUpdates->uploadTexture(m_texture, upload);
+        m_isFullUploadPending = false;
+        m_pendingRects.clear();
+    }
+
+private:
+    QRhiTextureSubresourceUploadDescription subresource(const QRect& rect) const
+    {
+        // premultiplied ARGB32 is stored as BGRA bytes, so it is uploaded in place
+        if (m_format == QRhiTexture::BGRA8)
+        {
+            QRhiTextureSubresourceUploadDescription description(m_image);
+            description.setSourceTopLeft(rect.topLeft());
+            description.setSourceSize(rect.size());
+            description.setDestinationTopLeft(rect.topLeft());
+            return description;
+        }
+        QRhiTextureSubresourceUploadDescription description(
+            m_image.copy(rect).convertToFormat(QImage::Format_RGBA8888_Premultiplied));
+        description.setDestinationTopLeft(rect.topLeft());
+        return description;
+    }
+
+private:
+    QImage m_image;
+    QRhiTexture* m_texture = nullptr;
+    QRhiTexture::Format m_format = QRhiTexture::BGRA8;
+    QList<QRect> m_pendingRects;
+    bool m_isFullUploadPending = true;
+};
+
+/**
+ * Colors of densities from 0 to 1, dark violet through red and yellow to white,
+ * premultiplied, the lowest densities are partially transparent
+ */
+const std::array<QRgb, 256>& heatmapPalette()
+{
+    static const auto palette = []() {
+        const std::array<QColor, 4> stops = {QColor(40, 0, 90, 160), QColor(220, 40, 40), QColor(250, 220, 50), QColor(255, 255, 255)};
+        std::array<QRgb, 256> colors{};
+        for (std::size_t i = 0; i < colors.size(); ++i)
+        {
+            const auto position = static_cast<double>(i) / (colors.size() - 1) * (stops.size() - 1);
+            const auto stop = std::min(static_cast<std::size_t>(position), stops.size() - 2);
+            const auto t = position - stop;
+            const auto mix = [t](int from, int to) { return static_cast<int>(from + (to - from) * t + 0.5); };
+            const auto& from = stops[stop];
+            const auto& to = stops[stop + 1];
+            colors[i] = qPremultiply(qRgba(mix(from.red(), to.red()), mix(from.green(), to.green()),
+                                           mix(from.blue(), to.blue()), mix(from.alpha(), to.alpha())));
+        }
+        return colors;
+    }();
+    return palette;
+}
+
+void deleteChildren(QSGNode* node)
+{
+    while (auto* child = node->firstChild())
+    {
+        node->removeChildNode(child);
+        delete child;
+    }
+}
+
+}  // namespace
 
 
 ImageProvider::ImageProvider(QQuickItem *parent)
@@ -23,27 +222,188 @@ void ImageProvider::setImage(const QImage& img)
     update();
 }
 
-QSGNode* ImageProvider::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData*)
+void ImageProvider::appendPoints(const api::Points& points)
+{
+    m_pendingPoints.append(points);
+    update();
+}
+
+void ImageProvider::appendHeatmap(const api::Heatmap& heatmap)
 {
-    QSGSimpleTextureNode* node = static_cast<QSGSimpleTextureNode*>(oldNode);
-    if (m_image.isNull())
+    const auto cells = static_cast<std::size_t>(heatmap.columns) * heatmap.rows;
+    if (!heatmap.isValid() || static_cast<std::size_t>(heatmap.counts.size()) != cells)
+        return;
+    // a different grid starts a new map
+    if (heatmap.area != m_heatmap.area || heatmap.columns != m_heatmap.columns || heatmap.rows != m_heatmap.rows)
+    {
+        m_heatmap = api::Heatmap{heatmap.area, heatmap.columns, heatmap.rows, {}};
+        m_heatmapCounts.assign(cells, 0);
+        m_heatmapMaximum = 0;
+    }
+    for (std::size_t i = 0; i < cells; ++i)
     {
-        delete node;
-        return nullptr;
+        m_heatmapCounts[i] += heatmap.counts[static_cast<qsizetype>(i)];
+        m_heatmapMaximum = std::max(m_heatmapMaximum, m_heatmapCounts[i]);
     }
+    m_isHeatmapDirty = true;
+    update();
+}
 
-    if (!node)
+void ImageProvider::clearPoints()
+{
+    m_pendingPoints.clear();
+    m_isPointsCleared = true;
+    m_heatmap = {};
+    m_heatmapCounts.clear();
+    m_heatmapMaximum = 0;
+    m_isHeatmapDirty = true;
+    update();
+}
+
+QImage ImageProvider::toneMapHeatmap() const
+{
+    // log scale keeps both sparse and dense regions visible
+    QImage image(m_heatmap.columns, m_heatmap.rows, QImage::Format_ARGB32_Premultiplied);
+    const auto& palette = heatmapPalette();
+    const auto scale = (palette.size() - 1) / std::log1p(static_cast<double>(std::max<quint64>(m_heatmapMaximum, 1)));
+    for (int row = 0; row < m_heatmap.rows; ++row)
     {
-        node = new QSGSimpleTextureNode();
+        auto* line = reinterpret_cast<QRgb*>(image.scanLine(row));
+        const auto* counts = m_heatmapCounts.data() + static_cast<std::size_t>(row) * m_heatmap.columns;
+        for (int column = 0; column < m_heatmap.columns; ++column)
+        {
+            const auto count = counts[column];
+            line[column] = count == 0 ? 0 : palette[static_cast<std::size_t>(std::log1p(static_cast<double>(count)) * scale)];
+        }
     }
+    return image;
+}
+
+bool ImageProvider::isTileChanged(const QRect& tile) const
+{
+    if (m_image.cacheKey() == m_uploadedImage.cacheKey())
+        return false;
+    if (m_image.depth() < 8)
+        return true;
+    const auto offset = static_cast<std::size_t>(tile.x()) * m_image.depth() / 8;
+    const auto bytes = static_cast<std::size_t>(tile.width()) * m_image.depth() / 8;
+    for (int y = tile.top(); y <= tile.bottom(); ++y)
+    {
+        if (std::memcmp(m_image.constScanLine(y) + offset, m_uploadedImage.constScanLine(y) + offset, bytes) != 0)
+            return true;
+    }
+    return false;
+}
+
+QSGNode* ImageProvider::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData*)
+{
+    // root transforms pixels of the image to the item, its children hold the image,
+    // the density map and chunks of points
+    auto* root = static_cast<QSGTransformNode*>(oldNode);
+    if (!root)
+    {
+        root = new QSGTransformNode();
+        root->appendChildNode(new QSGNode());
+        root->appendChildNode(new QSGNode());
+        root->appendChildNode(new QSGNode());
+    }
+    auto* imageLayer = root->firstChild();
+    auto* heatmapLayer = imageLayer->nextSibling();
+    auto* pointsLayer = root->lastChild();
 
     if (m_dirty && window())
     {
         m_dirty = false;
-        QSGTexture* texture = window()->createTextureFromImage(m_image);
-        node->setTexture(texture);
-        node->setOwnsTexture(true);
+        auto* node = static_cast<QSGSimpleTextureNode*>(imageLayer->firstChild());
+        if (m_image.isNull())
+        {
+            deleteChildren(imageLayer);
+        }
+        else
+        {
+            if (!node)
+            {
+                node = new QSGSimpleTextureNode();
+                node->setOwnsTexture(true);
+                imageLayer->appendChildNode(node);
+            }
+            node->setRect(m_image.rect());
+            auto* texture = dynamic_cast<ImageTexture*>(node->texture());
+            const auto isRebuilt = !texture || m_image.size() != m_uploadedImage.size()
+                                   || m_image.format() != m_uploadedImage.format();
+            if (!QSGRendererInterface::isApiRhiBased(window()->rendererInterface()->graphicsApi()))
+            {
+                // the software renderer draws only its own textures
+                node->setTexture(window()->createTextureFromImage(m_image));
+            }
+            else if (isRebuilt)
+            {
+                node->setTexture(new ImageTexture(m_image));
+            }
+            else
+            {
+                // changed tiles are uploaded to the texture, or the whole image when most of them changed
+                QList<QRect> dirtyTiles;
+                int tiles = 0;
+                for (int y = 0; y < m_image.height(); y += tileSize)
+                {
+                    for (int x = 0; x < m_image.width(); x += tileSize, ++tiles)
+                    {
+                        const auto tile = QRect(x, y, tileSize, tileSize).intersected(m_image.rect());
+                        if (isTileChanged(tile))
+                            dirtyTiles.append(tile);
+                    }
+                }
+                if (!dirtyTiles.isEmpty())
+                {
+                    texture->update(m_image, 2 * dirtyTiles.size() > tiles ? QList<QRect>{} : dirtyTiles);
+                    node->markDirty(QSGNode::DirtyMaterial);
+                }
+            }
+        }
+        m_uploadedImage = m_image;
     }
-    node->setRect(boundingRect());
-    return node;
+
+    if (m_isHeatmapDirty && window())
+    {
+        m_isHeatmapDirty = false;
+        deleteChildren(heatmapLayer);
+        if (m_heatmap.isValid())
+        {
+            auto* node = new QSGSimpleTextureNode();
+            node->setTexture(window()->createTextureFromImage(toneMapHeatmap()));
+            node->setOwnsTexture(true);
+            node->setRect(m_heatmap.area);
+            heatmapLayer->appendChildNode(node);
+        }
+    }
+
+    if (m_isPointsCleared)
+    {
+        m_isPointsCleared = false;
+        deleteChildren(pointsLayer);
+    }
+    const auto* points = m_pendingPoints.constData();
+    auto remaining = static_cast<int>(m_pendingPoints.size());
+    while (remaining > 0)
+    {
+        auto* chunk = static_cast<PointsNode*>(pointsLayer->lastChild());
+        if (!chunk || chunk->isFull())
+        {
+            chunk = new PointsNode();
+            pointsLayer->appendChildNode(chunk);
+        }
+        const auto taken = chunk->append(points, remaining);
+        points += taken;
+        remaining -= taken;
+    }
+    m_pendingPoints.clear();
+
+    // without an image points are given in pixels of the item
+    const auto canvas = m_image.isNull() ? boundingRect().size() : QSizeF(m_image.size());
+    QMatrix4x4 matrix;
+    if (!canvas.isEmpty())
+        matrix.scale(width() / canvas.width(), height() / canvas.height());
+    root->setMatrix(matrix);
+    return root;
 }
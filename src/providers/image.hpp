@@ -4,11 +4,28 @@
 #include <QQmlEngine>
 #include <QImage>
 
+#include <vector>
+
+#include "api/heatmap.hpp"
+#include "api/points.hpp"
+
 
 // no namespace, as it is registered as QML_ELEMENT
 // we could use it in .qml just as ImageProvider
 
 
+/**
+ * @brief The ImageProvider class
+ * Displays the animation of a simulation: the image uploaded to a texture
+ * when it changes, and points streamed over it, drawn from vertex buffers.
+ * The texture is kept between images, a new image is compared with the previous one
+ * in tiles and only tiles with changed pixels are uploaded, the whole image
+ * when most of them changed.
+ * Points are stored in the scene graph in chunks, a frame uploads only
+ * new chunks and the last, partially filled one.
+ * Counts of the density map are summed here and mapped to colors on a log scale
+ * once per frame, the texture has one texel per cell of the map.
+ */
 class ImageProvider : public QQuickItem
 {
     Q_OBJECT
@@ -16,6 +33,10 @@ class ImageProvider : public QQuickItem
 
     Q_PROPERTY(QImage image READ image WRITE setImage NOTIFY imageChanged)
 
+public:
+    static constexpr int pointsPerChunk = 1 << 14;
+    static constexpr int tileSize = 128;
+
 public:
     explicit ImageProvider(QQuickItem* parent = nullptr);
 
@@ -23,6 +44,13 @@ public:
 
 public slots:
     void setImage(const QImage& img);
+    void appendPoints(const api::Points& points);
+    void appendHeatmap(const api::Heatmap& heatmap);
+    /**
+     * @brief clearPoints
+     * Removes all points and the density map
+     */
+    void clearPoints();
 
 signals:
     void imageChanged();
@@ -31,7 +59,21 @@ protected:
     QSGNode* updatePaintNode(QSGNode* oldNode,
                              UpdatePaintNodeData* data) override;
 
+private:
+    bool isTileChanged(const QRect& tile) const;
+    QImage toneMapHeatmap() const;
+
 private:
     QImage m_image;
+    // image in the texture, to find the changed tiles
+    QImage m_uploadedImage;
     bool m_dirty = false;
+    // points received since the last frame, moved to the scene graph in updatePaintNode()
+    api::Points m_pendingPoints;
+    bool m_isPointsCleared = false;
+    // density map with counts summed over all batches
+    api::Heatmap m_heatmap;
+    std::vector<quint64> m_heatmapCounts;
+    quint64 m_heatmapMaximum = 0;
+    bool m_isHeatmapDirty = false;
 };
@@ -28,36 +28,42 @@ void Statistics::createAdapters(api::VariableMap statistics)
 {
     m_watchList = statistics.watch();
     m_adapters.reserve(m_watchList->size());
+    m_adaptersById.fill(nullptr, m_watchList->size());
     for (int i = 0; i < statistics.size(); ++i)
     {
         auto variable = statistics.number(i);
         if (!variable->name().isEmpty())
         {
-            m_adapters.append(new adapters::Statistic(variable->name(),
-                                                      variable->description(),
-                                                      *m_watchList,
-                                                      i,
-                                                      this));
+            auto* adapter = new adapters::Statistic(variable->name(),
+                                                    variable->description(),
+                                                    *m_watchList,
+                                                    i,
+                                                    this);
+            m_adapters.append(adapter);
+            m_adaptersById[i] = adapter;
         }
     }
 }
 
 void Statistics::updateFromMap(const QVariantMap& update)
 {
-    m_watchList->update(update);
-    for (auto& adapter : m_adapters)
-    {
-        dynamic_cast<adapters::Statistic*>(adapter)->updated();
-    }
-    emit changed();
+    notify(m_watchList->update(update));
 }
 
 void Statistics::updateWatched(const api::VariableMapSnapshot& update)
 {
-    m_watchList->update(update);
-    for (auto& adapter : m_adapters)
+    notify(m_watchList->update(update));
+}
+
+void Statistics::notify(const QList<int>& changedIds)
+{
+    // only statistics whose values moved are re-read by the view
+    if (changedIds.isEmpty())
+        return;
+    for (auto id : changedIds)
     {
-        dynamic_cast<adapters::Statistic*>(adapter)->updated();
+        if (auto* adapter = m_adaptersById.value(id))
+            adapter->updated();
     }
     emit changed();
 }
@@ -6,6 +6,8 @@
 #include "iprovider.hpp"
 #include "api/variable.hpp"
 
+namespace adapters { class Statistic; }
+
 
 namespace providers
 {
@@ -26,9 +28,11 @@ public slots:
 
 private:
     void createAdapters(api::VariableMap statistics);
+    void notify(const QList<int>& changedIds);
 
 private:
     QObjectList m_adapters;
+    QList<adapters::Statistic*> m_adaptersById;
     std::optional<api::VariableWatchList> m_watchList;
 };
 
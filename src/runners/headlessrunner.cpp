@@ -0,0 +1,156 @@
+#include "headlessrunner.hpp"
+
+#include <QThread>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "controllers/statisticsmerger.hpp"
+
+
+namespace runners
+{
+
+namespace
+{
+struct Instance
+{
+    std::unique_ptr<api::ISimulation> simulation;
+    std::unique_ptr<api::NumberGenerator> numberGenerator;
+    std::unique_ptr<api::IVariable> properties;
+    std::unique_ptr<api::IVariable> statistics;
+    qint64 firstIteration = 0;
+    qint64 iterations = 0;
+    QString error;
+};
+
+// SimpleSimulation and AnimatedSimulation share the lifecycle, but not the base class
+template <typename SimulationT>
+void execute(SimulationT* simulation, Instance& instance)
+{
+    simulation->_setup(instance.properties.get(), instance.statistics.get());
+    if (instance.error.isEmpty())
+        simulation->_runBatch(instance.numberGenerator.get(), instance.firstIteration, instance.iterations);
+    if (instance.error.isEmpty())
+        simulation->_teardown();
+}
+
+void execute(Instance& instance)
+{
+    if (auto simple = dynamic_cast<api::SimpleSimulation*>(instance.simulation.get()))
+        execute(simple, instance);
+    else if (auto animated = dynamic_cast<api::AnimatedSimulation*>(instance.simulation.get()))
+        execute(animated, instance);
+    else
+        instance.error = QString("Unsupported type of simulation");
+}
+}  // namespace
+
+
+HeadlessRunner::HeadlessRunner(api::ISimulationDLL* plugin)
+    : m_plugin{plugin}
+{
+    Q_ASSERT(m_plugin);
+}
+
+HeadlessRunner::Result HeadlessRunner::run(api::Variables properties, const Options& options) const
+{
+    auto result = Result{};
+    auto threads = static_cast<int>(std::clamp<qint64>(options.threads, 1, std::max(options.iterations, qint64{1})));
+
+    std::unique_ptr<controllers::StatisticsMerger> merger;
+    if (threads > 1)
+    {
+        merger = std::make_unique<controllers::StatisticsMerger>(m_plugin);
+        if (!merger->isSupported())
+        {
+            merger.reset();
+            threads = 1;
+        }
+    }
+
+    result.seed = options.seed != 0 ? options.seed : tools::NumberGeneratorFactory::randomSeed();
+    std::vector<Instance> instances(threads);
+    qint64 firstIteration = 0;
+    for (int i = 0; i < threads; ++i)
+    {
+        auto& instance = instances[i];
+        instance.simulation.reset(m_plugin->create());
+        instance.numberGenerator.reset(tools::NumberGeneratorFactory().create(result.seed, i, options.engine));
+        instance.properties.reset(properties->clone());
+        instance.statistics.reset(m_plugin->statistics()->clone());
+        instance.firstIteration = firstIteration;
+        instance.iterations = options.iterations / threads + (i < options.iterations % threads ? 1 : 0);
+        firstIteration += instance.iterations;
+        QObject::connect(instance.simulation.get(), &api::ISimulation::error, [&instance](const QString& message) {
+            if (instance.error.isEmpty())
+                instance.error = message;
+        });
+    }
+
+    const auto begin = std::chrono::steady_clock::now();
+    if (threads == 1)
+    {
+        execute(instances.front());
+    }
+    else
+    {
+        std::vector<std::unique_ptr<QThread>> workers;
+        workers.reserve(threads);
+        for (auto& instance : instances)
+        {
+            workers.emplace_back(QThread::create([&instance]() { execute(instance); }));
+            workers.back()->start();
+        }
+        for (auto& worker : workers)
+        {
+            worker->wait();
+        }
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    result.iterations = options.iterations;
+    result.threads = threads;
+
+    for (const auto& instance : instances)
+    {
+        if (!instance.error.isEmpty())
+        {
+            result.error = instance.error;
+            return result;
+        }
+    }
+
+    auto snapshots = std::vector<api::VariableMapSnapshot>{};
+    snapshots.reserve(instances.size());
+    for (const auto& instance : instances)
+    {
+        snapshots.push_back(api::VariableMap(instance.statistics.get()).snapshot());
+    }
+    auto snapshot = merger ? merger->merge(snapshots) : snapshots.front();
+
+    auto statistics = std::unique_ptr<api::IVariable>(m_plugin->statistics()->clone());
+    auto statisticsMap = api::VariableMap(statistics.get());
+    auto watchList = statisticsMap.watch();
+    watchList.update(snapshot);
+    for (int i = 0; i < static_cast<int>(statisticsMap.size()); ++i)
+    {
+        auto variable = dynamic_cast<api::IVariable*>(statisticsMap.number(i));
+        // groups have no value
+        if (variable && !variable->name().isEmpty() && variable->dataPointer())
+        {
+            result.statistics.append({displayName(*variable), watchList[i]});
+        }
+    }
+    return result;
+}
+
+QString HeadlessRunner::displayName(const api::IVariable& variable)
+{
+    auto name = variable.fullName();
+    if (name.startsWith(':'))
+        name.remove(0, 1);
+    return name;
+}
+
+}  // namespace runners
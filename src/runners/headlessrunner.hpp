@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QVariant>
+
+#include "api/simulation.hpp"
+#include "tools/numbergeneratorfactory.hpp"
+
+
+namespace runners
+{
+
+/**
+ * @brief The HeadlessRunner class
+ * Drives the simulation lifecycle (setup, run, teardown) synchronously,
+ * without an event loop and without any user interface, so nothing slows down run().
+ * With more than one thread, replicas of the simulation run in parallel
+ * and their statistics are merged at the end, the same way as in controllers.
+ * Every run works on its own copies of variables, many runs may be executed at the same time.
+ */
+class HeadlessRunner
+{
+public:
+    struct Options
+    {
+        qint64 iterations = 100;
+        int seed = 0;
+        int threads = 1;
+        tools::NumberGeneratorEngine engine = tools::NumberGeneratorEngine::MersenneTwister;
+    };
+
+    struct Result
+    {
+        QString error;
+        qint64 iterations = 0;
+        int threads = 0;
+        int seed = 0;  // seed actually used, drawn from entropy if options asked for a random seed
+        double seconds = 0.0;
+        QList<QPair<QString, QVariant>> statistics;
+    };
+
+public:
+    explicit HeadlessRunner(api::ISimulationDLL* plugin);
+
+    /**
+     * @brief run
+     * @param properties simulation properties, usually a modified clone of ISimulationDLL::properties()
+     * @param options course of the run
+     * @return final statistics, listed by their full names
+     */
+    Result run(api::Variables properties, const Options& options) const;
+
+    /**
+     * @brief displayName
+     * @return full name of the variable without the unnamed root group
+     */
+    static QString displayName(const api::IVariable& variable);
+
+private:
+    api::ISimulationDLL* m_plugin;
+};
+
+}  // namespace runners
@@ -0,0 +1,146 @@
+#include "sweepplan.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+
+namespace sweep
+{
+
+namespace
+{
+// range values are computed as doubles, integer properties get the nearest integer
+QVariant matchType(const QVariant& value, QMetaType type)
+{
+    if (type == QMetaType::fromType<int>())
+        return QVariant{static_cast<int>(std::lround(value.toDouble()))};
+    if (type == QMetaType::fromType<unsigned>())
+        return QVariant{static_cast<unsigned>(std::lround(std::max(value.toDouble(), 0.0)))};
+    return value;
+}
+}  // namespace
+
+
+Axis Axis::list(QString name, QVariantList values)
+{
+    auto axis = Axis{};
+    axis.name = std::move(name);
+    axis.values = std::move(values);
+    return axis;
+}
+
+Axis Axis::range(QString name, double from, double to, int steps)
+{
+    auto axis = Axis{};
+    axis.name = std::move(name);
+    axis.from = from;
+    axis.to = to;
+    axis.steps = steps;
+    return axis;
+}
+
+bool Axis::isRange() const
+{
+    return steps > 0;
+}
+
+QVariantList Axis::grid() const
+{
+    if (!isRange())
+        return values;
+    auto result = QVariantList{};
+    result.reserve(steps);
+    for (int i = 0; i < steps; ++i)
+    {
+        result.append(steps == 1 ? from : from + (to - from) * i / (steps - 1));
+    }
+    return result;
+}
+
+QVariant Axis::sample(double u) const
+{
+    if (isRange())
+        return from + (to - from) * u;
+    if (values.isEmpty())
+        return QVariant{};
+    auto index = std::min(static_cast<qsizetype>(u * values.size()), values.size() - 1);
+    return values[index];
+}
+
+
+QList<QVariantList> Plan::points(api::Variables properties) const
+{
+    auto propertyMap = api::VariableMap(properties);
+    auto types = QList<QMetaType>{};
+    for (const auto& axis : axes)
+    {
+        if (!axis.isRange() && axis.values.isEmpty())
+            throw std::runtime_error{QString("Sweep axis '%1' has no values").arg(axis.name).toStdString()};
+        types.append(propertyMap.named(axis.name)->type());
+    }
+
+    auto result = QList<QVariantList>{};
+    if (axes.isEmpty())
+        return result;
+
+    if (design == Design::Grid)
+    {
+        auto grids = QList<QVariantList>{};
+        for (const auto& axis : axes)
+        {
+            grids.append(axis.grid());
+        }
+        // odometer over all axes, the last axis changes the fastest
+        auto indices = std::vector<qsizetype>(axes.size(), 0);
+        while (true)
+        {
+            auto point = QVariantList{};
+            for (int i = 0; i < axes.size(); ++i)
+            {
+                point.append(matchType(grids[i][indices[i]], types[i]));
+            }
+            result.append(point);
+
+            int i = static_cast<int>(axes.size()) - 1;
+            for (; i >= 0; --i)
+            {
+                if (++indices[i] < grids[i].size())
+                    break;
+                indices[i] = 0;
+            }
+            if (i < 0)
+                break;
+        }
+        return result;
+    }
+
+    if (samples <= 0)
+        throw std::runtime_error{"Latin hypercube requires a positive number of samples"};
+
+    auto engine = std::mt19937{seed ? static_cast<std::mt19937::result_type>(seed) : std::random_device{}()};
+    auto uniform = std::uniform_real_distribution<double>(0.0, 1.0);
+    auto strata = std::vector<std::vector<int>>{};
+    for (int i = 0; i < axes.size(); ++i)
+    {
+        auto& permutation = strata.emplace_back(samples);
+        std::iota(permutation.begin(), permutation.end(), 0);
+        std::shuffle(permutation.begin(), permutation.end(), engine);
+    }
+    for (int s = 0; s < samples; ++s)
+    {
+        auto point = QVariantList{};
+        for (int i = 0; i < axes.size(); ++i)
+        {
+            const auto u = (strata[i][s] + uniform(engine)) / samples;
+            point.append(matchType(axes[i].sample(u), types[i]));
+        }
+        result.append(point);
+    }
+    return result;
+}
+
+}  // namespace sweep
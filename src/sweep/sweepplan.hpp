@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QVariant>
+
+#include "api/variable.hpp"
+
+
+namespace sweep
+{
+
+/**
+ * @brief The Axis struct
+ * Values of a single simulation property examined in a sweep.
+ * The axis is either an explicit list of values (any property type)
+ * or a numeric range, divided into evenly spaced steps on a grid.
+ */
+struct Axis
+{
+    QString name;
+    QVariantList values;
+    double from = 0.0;
+    double to = 0.0;
+    int steps = 0;
+
+    static Axis list(QString name, QVariantList values);
+    static Axis range(QString name, double from, double to, int steps);
+
+    bool isRange() const;
+
+    /**
+     * @brief grid
+     * @return values used by the grid design
+     */
+    QVariantList grid() const;
+
+    /**
+     * @brief sample
+     * @param u position on the axis in range [0, 1)
+     * @return value of the list or of the range at the position
+     */
+    QVariant sample(double u) const;
+};
+
+
+enum class Design
+{
+    Grid,
+    LatinHypercube
+};
+
+
+/**
+ * @brief The Plan struct
+ * Describes which combinations of properties are evaluated.
+ * Grid takes the cartesian product of all axes, Latin hypercube
+ * draws `samples` points, so that every axis is divided into `samples`
+ * strata and each stratum is hit exactly once.
+ */
+struct Plan
+{
+    QList<Axis> axes;
+    Design design = Design::Grid;
+    int samples = 10;
+    int seed = 0;
+
+    /**
+     * @brief points
+     * @param properties template of properties, used to match value types of the axes
+     * @return values of axes (in the order of axes) for every evaluated configuration
+     */
+    QList<QVariantList> points(api::Variables properties) const;
+};
+
+}  // namespace sweep
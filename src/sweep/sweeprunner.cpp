@@ -0,0 +1,125 @@
+#include "sweeprunner.hpp"
+
+#include <QThreadPool>
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "tools/numbergeneratorfactory.hpp"
+
+
+namespace sweep
+{
+
+namespace
+{
+QString escape(QString field, QChar separator)
+{
+    if (field.contains(separator) || field.contains('"') || field.contains('\n'))
+        return QString("\"%1\"").arg(field.replace("\"", "\"\""));
+    return field;
+}
+}  // namespace
+
+
+QString Table::toCsv(QChar separator) const
+{
+    const auto hasErrors = std::any_of(rows.begin(), rows.end(), [](const Row& row) { return !row.result.error.isEmpty(); });
+    auto lines = QStringList{};
+
+    auto header = QStringList{};
+    for (const auto& name : parameters + statistics)
+    {
+        header.append(escape(name, separator));
+    }
+    if (hasErrors)
+        header.append("error");
+    lines.append(header.join(separator));
+
+    for (const auto& row : rows)
+    {
+        auto fields = QStringList{};
+        for (const auto& value : row.parameters)
+        {
+            fields.append(escape(value.toString(), separator));
+        }
+        for (int i = 0; i < statistics.size(); ++i)
+        {
+            fields.append(i < row.result.statistics.size() ? escape(row.result.statistics[i].second.toString(), separator) : QString{});
+        }
+        if (hasErrors)
+            fields.append(escape(row.result.error, separator));
+        lines.append(fields.join(separator));
+    }
+    return lines.join('\n') + '\n';
+}
+
+
+SweepRunner::SweepRunner(api::ISimulationDLL* plugin)
+    : m_plugin{plugin}
+{
+    Q_ASSERT(m_plugin);
+}
+
+Table SweepRunner::run(const Plan& plan, api::Variables properties, const Options& options) const
+{
+    auto table = Table{};
+    for (const auto& axis : plan.axes)
+    {
+        table.parameters.append(axis.name);
+    }
+
+    const auto points = plan.points(properties);
+
+    // every configuration is prepared up front, workers only read their own copy
+    auto configurations = std::vector<std::unique_ptr<api::IVariable>>{};
+    configurations.reserve(points.size());
+    for (const auto& point : points)
+    {
+        auto& configuration = configurations.emplace_back(properties->clone());
+        auto configurationMap = api::VariableMap(configuration.get());
+        for (int i = 0; i < plan.axes.size(); ++i)
+        {
+            if (!configurationMap.named(plan.axes[i].name)->set(point[i]))
+                throw std::runtime_error{QString("Invalid value '%1' of property '%2'").arg(point[i].toString(), plan.axes[i].name).toStdString()};
+        }
+        table.rows.append(Table::Row{point, {}});
+    }
+
+    // a random seed is drawn once, so configurations still share their random numbers
+    auto runOptions = options.run;
+    if (runOptions.seed == 0)
+        runOptions.seed = tools::NumberGeneratorFactory::randomSeed();
+
+    auto results = std::vector<runners::HeadlessRunner::Result>(configurations.size());
+    QThreadPool pool;
+    if (options.concurrency > 0)
+        pool.setMaxThreadCount(options.concurrency);
+    for (int i = 0; i < static_cast<int>(configurations.size()); ++i)
+    {
+        pool.start([this, &results, &configurations, &runOptions, i]() {
+            results[i] = runners::HeadlessRunner(m_plugin).run(configurations[i].get(), runOptions);
+        });
+    }
+    pool.waitForDone();
+    for (int i = 0; i < static_cast<int>(results.size()); ++i)
+    {
+        table.rows[i].result = std::move(results[i]);
+    }
+
+    for (const auto& row : table.rows)
+    {
+        if (row.result.error.isEmpty())
+        {
+            for (const auto& [name, value] : row.result.statistics)
+            {
+                table.statistics.append(name);
+            }
+            break;
+        }
+    }
+    return table;
+}
+
+}  // namespace sweep
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+
+#include "api/simulation.hpp"
+#include "runners/headlessrunner.hpp"
+#include "sweepplan.hpp"
+
+
+namespace sweep
+{
+
+/**
+ * @brief The Table struct
+ * Results of a sweep, one row for every evaluated configuration.
+ * Columns are names of swept properties followed by names of statistics.
+ */
+struct Table
+{
+    struct Row
+    {
+        QVariantList parameters;
+        runners::HeadlessRunner::Result result;
+    };
+
+    QStringList parameters;
+    QStringList statistics;
+    QList<Row> rows;
+
+    QString toCsv(QChar separator = ',') const;
+};
+
+
+/**
+ * @brief The SweepRunner class
+ * Evaluates configurations of the plan concurrently on a thread pool.
+ * Every configuration gets its own copy of properties and its own
+ * simulation instances, so the plugin's properties() are never modified.
+ * All configurations use the same seed (common random numbers),
+ * differences between rows come from properties, not from the noise.
+ */
+class SweepRunner
+{
+public:
+    struct Options
+    {
+        runners::HeadlessRunner::Options run;
+        int concurrency = 0;  // 0 uses all cores
+    };
+
+public:
+    explicit SweepRunner(api::ISimulationDLL* plugin);
+
+    /**
+     * @brief run
+     * @param plan swept properties and design of the sweep
+     * @param properties base values of properties not swept by the plan
+     * @param options course of every single run and number of concurrent runs
+     * @return results in the order of plan points
+     */
+    Table run(const Plan& plan, api::Variables properties, const Options& options) const;
+
+private:
+    api::ISimulationDLL* m_plugin;
+};
+
+}  // namespace sweep
@@ -2,6 +2,8 @@
 
 #include "determinenumbergenerator.hpp"
 
+#include <sstream>
+
 
 namespace api
 {
@@ -10,6 +12,17 @@ DetermineNumberGenerator::DetermineNumberGenerator(int seed)
     : m_gen(seed)
 {}
 
+DetermineNumberGenerator::DetermineNumberGenerator(int seed, int stream)
+    : m_gen(seed)
+{
+    // stream 0 is the same as the plain seed, so single threaded results stay reproducible
+    if (stream != 0)
+    {
+        std::seed_seq sequence{seed, stream};
+        m_gen.seed(sequence);
+    }
+}
+
 int DetermineNumberGenerator::operator()()
 {
     return m_gen();
@@ -30,4 +43,39 @@ double DetermineNumberGenerator::real(double from, double to)
     return std::uniform_real_distribution(from, to)(m_gen);
 }
 
+void DetermineNumberGenerator::fill(std::span<double> values, double from, double to)
+{
+    const auto scale = to - from;
+    for (auto& value : values)
+    {
+        const auto high = static_cast<quint32>(m_gen());
+        value = from + scale * toUnitInterval(high, static_cast<quint32>(m_gen()));
+    }
+}
+
+void DetermineNumberGenerator::fill(std::span<int> values, int from, int to)
+{
+    auto distribution = std::uniform_int_distribution(from, to);
+    for (auto& value : values)
+        value = distribution(m_gen);
+}
+
+QByteArray DetermineNumberGenerator::saveEngineState() const
+{
+    std::ostringstream stream;
+    stream << m_gen;
+    return QByteArray::fromStdString(stream.str());
+}
+
+bool DetermineNumberGenerator::restoreEngineState(const QByteArray& state)
+{
+    std::istringstream stream(state.toStdString());
+    auto generator = std::mt19937{};
+    stream >> generator;
+    if (stream.fail())
+        return false;
+    m_gen = generator;
+    return true;
+}
+
 }  // namespace api
@@ -13,11 +13,18 @@ class DetermineNumberGenerator : public NumberGenerator
 
 public:
     DetermineNumberGenerator(int seed);
+    DetermineNumberGenerator(int seed, int stream);
 
     int operator()() override;
     int operator()(int to) override;
     int operator()(int from, int to) override;
     double real(double from, double to) override;
+    void fill(std::span<double> values, double from, double to) override;
+    void fill(std::span<int> values, int from, int to) override;
+
+protected:
+    QByteArray saveEngineState() const override;
+    bool restoreEngineState(const QByteArray& state) override;
 
 private:
     std::mt19937 m_gen;
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "api/tools.hpp"
+#include <QDataStream>
+#include <QIODevice>
+#include <cstdint>
+#include <random>
+
+
+namespace api
+{
+
+/**
+ * @brief The EngineNumberGenerator class
+ * Generator driven by one of small-state engines from tools/engines.hpp.
+ * Streams of the same seed are separated by jumps of the engine, so they never overlap.
+ * Templates cannot use Q_OBJECT, the class adds no signals nor slots.
+ */
+template <typename Engine>
+class EngineNumberGenerator : public NumberGenerator
+{
+public:
+    EngineNumberGenerator(std::uint64_t seed, int stream)
+        : m_engine{seed}
+    {
+        for (int i = 0; i < stream; ++i)
+            m_engine.jump();
+    }
+
+    int operator()() override
+    {
+        return static_cast<int>(m_engine());
+    }
+
+    int operator()(int to) override
+    {
+        return std::uniform_int_distribution(0, to)(m_engine);
+    }
+
+    int operator()(int from, int to) override
+    {
+        return std::uniform_int_distribution(from, to)(m_engine);
+    }
+
+    double real(double from, double to) override
+    {
+        return std::uniform_real_distribution(from, to)(m_engine);
+    }
+
+    void fill(std::span<double> values, double from, double to) override
+    {
+        const auto scale = to - from;
+        for (auto& value : values)
+            value = from + scale * (static_cast<double>(m_engine() >> 11) * (1.0 / 9007199254740992.0));
+    }
+
+    void fill(std::span<int> values, int from, int to) override
+    {
+        auto distribution = std::uniform_int_distribution(from, to);
+        for (auto& value : values)
+            value = distribution(m_engine);
+    }
+
+protected:
+    QByteArray saveEngineState() const override
+    {
+        QByteArray state;
+        QDataStream stream(&state, QIODevice::WriteOnly);
+        for (auto word : m_engine.state())
+            stream << static_cast<quint64>(word);
+        return state;
+    }
+
+    bool restoreEngineState(const QByteArray& state) override
+    {
+        QDataStream stream(state);
+        auto words = typename Engine::State{};
+        for (auto& word : words)
+        {
+            quint64 value = 0;
+            stream >> value;
+            word = value;
+        }
+        if (stream.status() != QDataStream::Ok)
+            return false;
+        m_engine.setState(words);
+        return true;
+    }
+
+private:
+    Engine m_engine;
+};
+
+}  // namespace api
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+
+
+namespace tools
+{
+
+/**
+ * Small-state engines of random numbers. All of them meet requirements of
+ * UniformRandomBitGenerator with 64-bit results, so they work with std distributions.
+ * jump() and longJump() advance the engine by a fixed, large number of steps
+ * to create non-overlapping substreams of the same seed.
+ */
+
+/**
+ * @brief The SplitMix64 class
+ * Weyl sequence with a mixing function (Steele, Lea, Flood), period 2^64.
+ * Also used to seed other engines from a single number.
+ */
+class SplitMix64
+{
+public:
+    using result_type = std::uint64_t;
+    using State = std::array<std::uint64_t, 1>;
+
+    static constexpr std::uint64_t gamma = 0x9E3779B97F4A7C15;
+
+public:
+    explicit SplitMix64(std::uint64_t seed = 0) : m_state{seed} {}
+
+    static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()()
+    {
+        auto z = (m_state += gamma);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+        return z ^ (z >> 31);
+    }
+
+    /**
+     * @brief jump
+     * Advances the engine by 2^48 steps, which gives 2^16 substreams
+     */
+    void jump() { m_state += gamma << 48; }
+
+    /**
+     * @brief longJump
+     * Advances the engine by 2^56 steps
+     */
+    void longJump() { m_state += gamma << 56; }
+
+    State state() const { return {m_state}; }
+    void setState(const State& state) { m_state = state[0]; }
+
+private:
+    std::uint64_t m_state;
+};
+
+
+/**
+ * @brief The Xoshiro256StarStar class
+ * xoshiro256** 1.0 (Blackman, Vigna), period 2^256 - 1
+ */
+class Xoshiro256StarStar
+{
+public:
+    using result_type = std::uint64_t;
+    using State = std::array<std::uint64_t, 4>;
+
+public:
+    explicit Xoshiro256StarStar(std::uint64_t seed = 0)
+    {
+        // the state must not be all zeros, SplitMix64 never returns four zeros in a row
+        auto seeder = SplitMix64{seed};
+        for (auto& word : m_state)
+            word = seeder();
+    }
+
+    static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()()
+    {
+        const auto result = std::rotl(m_state[1] * 5, 7) * 9;
+        const auto t = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = std::rotl(m_state[3], 45);
+        return result;
+    }
+
+    /**
+     * @brief jump
+     * Advances the engine by 2^128 steps, which gives 2^128 substreams
+     */
+    void jump() { jump({0x180EC6D33CFD0ABA, 0xD5A61266F0C9392C, 0xA9582618E03FC9AA, 0x39ABDC4529B1661C}); }
+
+    /**
+     * @brief longJump
+     * Advances the engine by 2^192 steps
+     */
+    void longJump() { jump({0x76E15D3EFEFDCBBF, 0xC5004E441C522FB3, 0x77710069854EE241, 0x39109BB02ACBE635}); }
+
+    State state() const { return m_state; }
+    void setState(const State& state) { m_state = state; }
+
+private:
+    void jump(const State& polynomial)
+    {
+        auto state = State{};
+        for (auto word : polynomial)
+        {
+            for (int bit = 0; bit < 64; ++bit)
+            {
+                if (word & (std::uint64_t{1} << bit))
+                {
+                    for (std::size_t i = 0; i < state.size(); ++i)
+                        state[i] ^= m_state[i];
+                }
+                (*this)();
+            }
+        }
+        m_state = state;
+    }
+
+private:
+    State m_state;
+};
+
+
+/**
+ * @brief The Pcg64 class
+ * PCG XSL-RR 128/64 (O'Neill), 128-bit linear congruential generator with
+ * a permuted output, period 2^128. Equal to pcg64 of the reference implementation.
+ */
+class Pcg64
+{
+public:
+    using result_type = std::uint64_t;
+    using State = std::array<std::uint64_t, 4>;
+
+    /**
+     * @brief The UInt128 struct
+     * Portable unsigned 128-bit arithmetic modulo 2^128
+     */
+    struct UInt128
+    {
+        std::uint64_t high;
+        std::uint64_t low;
+
+        friend UInt128 operator+(UInt128 lhs, UInt128 rhs)
+        {
+            const auto low = lhs.low + rhs.low;
+            return {lhs.high + rhs.high + (low < lhs.low ? 1 : 0), low};
+        }
+
+        friend UInt128 operator*(UInt128 lhs, UInt128 rhs)
+        {
+#if defined(__SIZEOF_INT128__)
+            const auto product = static_cast<unsigned __int128>(lhs.low) * rhs.low;
+            const auto carry = static_cast<std::uint64_t>(product >> 64);
+            return {lhs.high * rhs.low + lhs.low * rhs.high + carry, static_cast<std::uint64_t>(product)};
+#else
+            const auto a0 = lhs.low & 0xFFFFFFFF, a1 = lhs.low >> 32;
+            const auto b0 = rhs.low & 0xFFFFFFFF, b1 = rhs.low >> 32;
+            const auto p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+            const auto middle = (p00 >> 32) + (p01 & 0xFFFFFFFF) + (p10 & 0xFFFFFFFF);
+            const auto carry = p11 + (p01 >> 32) + (p10 >> 32) + (middle >> 32);
+            return {lhs.high * rhs.low + lhs.low * rhs.high + carry, (middle << 32) | (p00 & 0xFFFFFFFF)};
+#endif
+        }
+
+        friend bool operator==(UInt128 lhs, UInt128 rhs) = default;
+    };
+
+    static constexpr UInt128 multiplier = {0x2360ED051FC65DA4, 0x4385DF649FCCF645};
+    static constexpr UInt128 defaultIncrement = {0x5851F42D4C957F2D, 0x14057B7EF767814F};
+
+public:
+    explicit Pcg64(std::uint64_t seed = 0)
+    {
+        auto seeder = SplitMix64{seed};
+        const auto high = seeder();
+        seed128({high, seeder()}, defaultIncrement);
+    }
+
+    /**
+     * @brief Pcg64
+     * Seeds the engine the same way as pcg_setseq_128_srandom_r() of the reference implementation
+     */
+    Pcg64(UInt128 state, UInt128 sequence)
+    {
+        seed128(state, {(sequence.high << 1) | (sequence.low >> 63), (sequence.low << 1) | 1});
+    }
+
+    static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()()
+    {
+        step();
+        return std::rotr(m_state.high ^ m_state.low, static_cast<int>(m_state.high >> 58));
+    }
+
+    /**
+     * @brief advance
+     * Advances the engine by the given number of steps in O(log(steps)) (Brown, "Random number generation with arbitrary strides")
+     */
+    void advance(UInt128 steps)
+    {
+        auto accumulatedMultiplier = UInt128{0, 1};
+        auto accumulatedIncrement = UInt128{0, 0};
+        auto currentMultiplier = multiplier;
+        auto currentIncrement = m_increment;
+        while (steps.high != 0 || steps.low != 0)
+        {
+            if (steps.low & 1)
+            {
+                accumulatedMultiplier = accumulatedMultiplier * currentMultiplier;
+                accumulatedIncrement = accumulatedIncrement * currentMultiplier + currentIncrement;
+            }
+            currentIncrement = (currentMultiplier + UInt128{0, 1}) * currentIncrement;
+            currentMultiplier = currentMultiplier * currentMultiplier;
+            steps = {steps.high >> 1, (steps.low >> 1) | (steps.high << 63)};
+        }
+        m_state = accumulatedMultiplier * m_state + accumulatedIncrement;
+    }
+
+    /**
+     * @brief jump
+     * Advances the engine by 2^64 steps, which gives 2^64 substreams
+     */
+    void jump() { advance({1, 0}); }
+
+    /**
+     * @brief longJump
+     * Advances the engine by 2^96 steps
+     */
+    void longJump() { advance({std::uint64_t{1} << 32, 0}); }
+
+    State state() const { return {m_state.high, m_state.low, m_increment.high, m_increment.low}; }
+    void setState(const State& state)
+    {
+        m_state = {state[0], state[1]};
+        m_increment = {state[2], state[3] | 1};
+    }
+
+private:
+    void step() { m_state = m_state * multiplier + m_increment; }
+
+    void seed128(UInt128 state, UInt128 increment)
+    {
+        m_state = {0, 0};
+        m_increment = increment;
+        step();
+        m_state = m_state + state;
+        step();
+    }
+
+private:
+    UInt128 m_state;
+    UInt128 m_increment;
+};
+
+}  // namespace tools
@@ -0,0 +1,48 @@
+#include "haltonnumbergenerator.hpp"
+
+
+namespace api
+{
+
+HaltonNumberGenerator::HaltonNumberGenerator(quint64 seed)
+    : QuasiRandomNumberGenerator(seed)
+{
+    quint32 candidate = 2;
+    for (int dimension = 0; dimension < maxDimensions; ++candidate)
+    {
+        bool isPrime = true;
+        for (int i = 0; i < dimension && m_bases[i] * m_bases[i] <= candidate; ++i)
+        {
+            if (candidate % m_bases[i] == 0)
+            {
+                isPrime = false;
+                break;
+            }
+        }
+        if (isPrime)
+            m_bases[dimension++] = candidate;
+    }
+
+    for (int dimension = 0; dimension < maxDimensions; ++dimension)
+        m_shifts[dimension] = static_cast<double>(hash(~quint64{0}, dimension) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+int HaltonNumberGenerator::dimensions() const
+{
+    return maxDimensions;
+}
+
+double HaltonNumberGenerator::coordinate(quint64 index, int dimension) const
+{
+    // radical inverse of the index in the prime base
+    const auto base = m_bases[dimension];
+    const auto inverseBase = 1.0 / base;
+    auto factor = inverseBase;
+    auto value = 0.0;
+    for (; index != 0; index /= base, factor *= inverseBase)
+        value += static_cast<double>(index % base) * factor;
+    value += m_shifts[dimension];
+    return value >= 1.0 ? value - 1.0 : value;
+}
+
+}  // namespace api
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "quasirandomnumbergenerator.hpp"
+#include <array>
+
+
+namespace api
+{
+
+/**
+ * @brief The HaltonNumberGenerator class
+ * Halton sequence in 64 dimensions (radical inverses in bases of consecutive primes),
+ * randomized with a random shift modulo 1 (Cranley, Patterson).
+ * Best suited for low dimensions, high dimensions of Halton points are correlated.
+ */
+class HaltonNumberGenerator : public QuasiRandomNumberGenerator
+{
+    Q_OBJECT
+
+public:
+    static constexpr int maxDimensions = 64;
+
+public:
+    explicit HaltonNumberGenerator(quint64 seed);
+
+protected:
+    int dimensions() const override;
+    double coordinate(quint64 index, int dimension) const override;
+
+private:
+    std::array<quint32, maxDimensions> m_bases;
+    std::array<double, maxDimensions> m_shifts;
+};
+
+}  // namespace api
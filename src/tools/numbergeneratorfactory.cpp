@@ -1,7 +1,15 @@
 #include "numbergeneratorfactory.hpp"
 
 #include "determinenumbergenerator.hpp"
+#include "enginenumbergenerator.hpp"
+#include "engines.hpp"
+#include "haltonnumbergenerator.hpp"
+#include "philoxnumbergenerator.hpp"
 #include "randomnumbergenerator.hpp"
+#include "sobolnumbergenerator.hpp"
+
+#include <limits>
+#include <random>
 
 
 namespace tools
@@ -20,4 +28,76 @@ api::NumberGenerator* NumberGeneratorFactory::create(int seed,
     }
 }
 
+api::NumberGenerator* NumberGeneratorFactory::create(int seed,
+                                                     int stream,
+                                                     NumberGeneratorDistribution distribiution)
+{
+    if (seed == 0)
+    {
+        return new api::RandomNumberGenerator(stream);
+    }
+    else
+    {
+        return new api::DetermineNumberGenerator(seed, stream);
+    }
+}
+
+api::NumberGenerator* NumberGeneratorFactory::create(int seed,
+                                                     int stream,
+                                                     NumberGeneratorEngine engine,
+                                                     NumberGeneratorDistribution distribiution)
+{
+    if (engine == NumberGeneratorEngine::MersenneTwister)
+        return create(seed, stream, distribiution);
+
+    const auto key = static_cast<quint32>(seed == 0 ? randomSeed() : seed);
+    switch (engine)
+    {
+    case NumberGeneratorEngine::Philox:
+        return new api::PhiloxNumberGenerator(key);
+    case NumberGeneratorEngine::Xoshiro256StarStar:
+        return new api::EngineNumberGenerator<Xoshiro256StarStar>(key, stream);
+    case NumberGeneratorEngine::Pcg64:
+        return new api::EngineNumberGenerator<Pcg64>(key, stream);
+    case NumberGeneratorEngine::SplitMix64:
+        return new api::EngineNumberGenerator<SplitMix64>(key, stream);
+    case NumberGeneratorEngine::Sobol:
+        return new api::SobolNumberGenerator(key);
+    case NumberGeneratorEngine::Halton:
+        return new api::HaltonNumberGenerator(key);
+    default:
+        return create(seed, stream, distribiution);
+    }
+}
+
+int NumberGeneratorFactory::randomSeed()
+{
+    // the only read of the entropy source, numbers come from a seeded engine
+    return std::uniform_int_distribution(1, std::numeric_limits<int>::max())(std::random_device{});
+}
+
+QStringList NumberGeneratorFactory::engineNames()
+{
+    return {"mt19937", "philox", "xoshiro256**", "pcg64", "splitmix64", "sobol", "halton"};
+}
+
+std::optional<NumberGeneratorEngine> NumberGeneratorFactory::engine(const QString& name)
+{
+    if (name == "mt19937")
+        return NumberGeneratorEngine::MersenneTwister;
+    if (name == "philox")
+        return NumberGeneratorEngine::Philox;
+    if (name == "xoshiro256**")
+        return NumberGeneratorEngine::Xoshiro256StarStar;
+    if (name == "pcg64")
+        return NumberGeneratorEngine::Pcg64;
+    if (name == "splitmix64")
+        return NumberGeneratorEngine::SplitMix64;
+    if (name == "sobol")
+        return NumberGeneratorEngine::Sobol;
+    if (name == "halton")
+        return NumberGeneratorEngine::Halton;
+    return std::nullopt;
+}
+
 }  // namespace tools
@@ -1,16 +1,46 @@
 #pragma once
 
 #include "api/tools.hpp"
+#include <QStringList>
+#include <optional>
 
 
 namespace tools
 {
 
+/**
+ * @brief The NumberGeneratorDistribution enum
+ * Distribution of numbers returned by generators. Simulations sample other distributions
+ * from the uniform numbers with samplers of api/distributions.hpp, one generator
+ * serves all distributions used in an iteration.
+ */
 enum class NumberGeneratorDistribution
 {
     Uniform
 };
 
+/**
+ * @brief The NumberGeneratorEngine enum
+ * MersenneTwister gives every parallel simulation its own stream of numbers,
+ * Philox computes numbers of every iteration from the seed and the index of the iteration,
+ * so the numbers do not depend on the number of threads (merged floating-point statistics
+ * still differ in rounding).
+ * Xoshiro256StarStar, Pcg64 and SplitMix64 are fast engines with small state,
+ * their parallel streams are non-overlapping substreams of the same seed.
+ * Sobol and Halton are randomized low-discrepancy sequences, iteration i gets the point i
+ * of the sequence, numbers drawn in the iteration are its coordinates.
+ */
+enum class NumberGeneratorEngine
+{
+    MersenneTwister,
+    Philox,
+    Xoshiro256StarStar,
+    Pcg64,
+    SplitMix64,
+    Sobol,
+    Halton
+};
+
 
 class NumberGeneratorFactory : public QObject
 {
@@ -21,6 +51,45 @@ public:
 
     api::NumberGenerator* create(int seed,
                                  NumberGeneratorDistribution distribiution = NumberGeneratorDistribution::Uniform);
+
+    /**
+     * @brief create
+     * Creates one of independent streams of numbers for the same seed,
+     * used by simulations running in parallel. Stream 0 equals create(seed).
+     */
+    api::NumberGenerator* create(int seed,
+                                 int stream,
+                                 NumberGeneratorDistribution distribiution = NumberGeneratorDistribution::Uniform);
+
+    /**
+     * @brief create
+     * Creates the stream of numbers of the chosen engine. Philox generators
+     * of the same seed are identical for all streams, the iteration index tells them apart.
+     */
+    api::NumberGenerator* create(int seed,
+                                 int stream,
+                                 NumberGeneratorEngine engine,
+                                 NumberGeneratorDistribution distribiution = NumberGeneratorDistribution::Uniform);
+
+    /**
+     * @brief randomSeed
+     * Draws a seed from the entropy source. Runs with seed 0 use such seed,
+     * it should be shown to the user, so the run can be replayed.
+     * @return positive seed
+     */
+    static int randomSeed();
+
+    /**
+     * @brief engineNames
+     * @return names of engines, accepted by engine()
+     */
+    static QStringList engineNames();
+
+    /**
+     * @brief engine
+     * @return engine of the given name or nothing if the name is unknown
+     */
+    static std::optional<NumberGeneratorEngine> engine(const QString& name);
 };
 
 }  // namespace tools
@@ -0,0 +1,159 @@
+#include "philoxnumbergenerator.hpp"
+
+#include <QDataStream>
+#include <QIODevice>
+#include <limits>
+#include <random>
+
+
+namespace api
+{
+
+/**
+ * @brief The PhiloxNumberGenerator::Engine struct
+ * Adapts the generator to std distributions
+ */
+struct PhiloxNumberGenerator::Engine
+{
+    using result_type = std::uint32_t;
+
+    static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+    result_type operator()() { return generator.next(); }
+
+    PhiloxNumberGenerator& generator;
+};
+
+PhiloxNumberGenerator::PhiloxNumberGenerator(quint64 seed)
+    : m_key{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)}
+    , m_counter{}
+    , m_buffer{}
+    , m_index{static_cast<int>(m_buffer.size())}
+{
+    // iterations usually draw only a few numbers, larger blocks would be discarded
+    setCounterBased(4);
+}
+
+int PhiloxNumberGenerator::operator()()
+{
+    return static_cast<int>(next());
+}
+
+int PhiloxNumberGenerator::operator()(int to)
+{
+    auto engine = Engine{*this};
+    return std::uniform_int_distribution(0, to)(engine);
+}
+
+int PhiloxNumberGenerator::operator()(int from, int to)
+{
+    auto engine = Engine{*this};
+    return std::uniform_int_distribution(from, to)(engine);
+}
+
+double PhiloxNumberGenerator::real(double from, double to)
+{
+    auto engine = Engine{*this};
+    return std::uniform_real_distribution(from, to)(engine);
+}
+
+void PhiloxNumberGenerator::fill(std::span<double> values, double from, double to)
+{
+    const auto scale = to - from;
+    for (auto& value : values)
+    {
+        const auto high = next();
+        value = from + scale * toUnitInterval(high, next());
+    }
+}
+
+void PhiloxNumberGenerator::fill(std::span<int> values, int from, int to)
+{
+    auto engine = Engine{*this};
+    auto distribution = std::uniform_int_distribution(from, to);
+    for (auto& value : values)
+        value = distribution(engine);
+}
+
+void PhiloxNumberGenerator::setIteration(qint64 iteration)
+{
+    // words 0-1 count blocks drawn in the iteration, words 2-3 hold the iteration
+    const auto index = static_cast<quint64>(iteration);
+    m_counter = {0, 0, static_cast<std::uint32_t>(index), static_cast<std::uint32_t>(index >> 32)};
+    m_index = static_cast<int>(m_buffer.size());
+}
+
+QByteArray PhiloxNumberGenerator::saveEngineState() const
+{
+    QByteArray state;
+    QDataStream stream(&state, QIODevice::WriteOnly);
+    for (auto word : m_key)
+        stream << word;
+    for (auto word : m_counter)
+        stream << word;
+    for (auto word : m_buffer)
+        stream << word;
+    stream << static_cast<qint32>(m_index);
+    return state;
+}
+
+bool PhiloxNumberGenerator::restoreEngineState(const QByteArray& state)
+{
+    QDataStream stream(state);
+    auto key = Key{};
+    auto counter = Block{};
+    auto buffer = Block{};
+    qint32 index = 0;
+    for (auto& word : key)
+        stream >> word;
+    for (auto& word : counter)
+        stream >> word;
+    for (auto& word : buffer)
+        stream >> word;
+    stream >> index;
+    if (stream.status() != QDataStream::Ok || index < 0 || index > static_cast<qint32>(buffer.size()))
+        return false;
+    m_key = key;
+    m_counter = counter;
+    m_buffer = buffer;
+    m_index = index;
+    return true;
+}
+
+PhiloxNumberGenerator::Block PhiloxNumberGenerator::block(Block counter, Key key)
+{
+    constexpr std::uint64_t multiplier0 = 0xD2511F53;
+    constexpr std::uint64_t multiplier1 = 0xCD9E8D57;
+    constexpr std::uint32_t weyl0 = 0x9E3779B9;
+    constexpr std::uint32_t weyl1 = 0xBB67AE85;
+
+    for (int round = 0; round < 10; ++round)
+    {
+        if (round > 0)
+        {
+            key[0] += weyl0;
+            key[1] += weyl1;
+        }
+        const auto product0 = multiplier0 * counter[0];
+        const auto product1 = multiplier1 * counter[2];
+        counter = {static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+                   static_cast<std::uint32_t>(product1),
+                   static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+                   static_cast<std::uint32_t>(product0)};
+    }
+    return counter;
+}
+
+std::uint32_t PhiloxNumberGenerator::next()
+{
+    if (m_index == static_cast<int>(m_buffer.size()))
+    {
+        m_buffer = block(m_counter, m_key);
+        if (++m_counter[0] == 0)
+            ++m_counter[1];
+        m_index = 0;
+    }
+    return m_buffer[m_index++];
+}
+
+}  // namespace api
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "api/tools.hpp"
+#include <array>
+#include <cstdint>
+
+
+namespace api
+{
+
+/**
+ * @brief The PhiloxNumberGenerator class
+ * Counter-based generator Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3").
+ * Numbers of every iteration are computed from the seed and the index of the iteration only,
+ * so the results do not depend on how iterations are split between threads and batches.
+ */
+class PhiloxNumberGenerator : public NumberGenerator
+{
+    Q_OBJECT
+
+public:
+    using Block = std::array<std::uint32_t, 4>;
+    using Key = std::array<std::uint32_t, 2>;
+
+public:
+    explicit PhiloxNumberGenerator(quint64 seed);
+
+    int operator()() override;
+    int operator()(int to) override;
+    int operator()(int from, int to) override;
+    double real(double from, double to) override;
+    void fill(std::span<double> values, double from, double to) override;
+    void fill(std::span<int> values, int from, int to) override;
+
+    /**
+     * @brief block
+     * @return Philox4x32-10 bijection of the counter for the given key
+     */
+    static Block block(Block counter, Key key);
+
+protected:
+    void setIteration(qint64 iteration) override;
+    QByteArray saveEngineState() const override;
+    bool restoreEngineState(const QByteArray& state) override;
+
+private:
+    struct Engine;
+
+    std::uint32_t next();
+
+private:
+    Key m_key;
+    Block m_counter;
+    Block m_buffer;
+    int m_index;
+};
+
+}  // namespace api
@@ -0,0 +1,99 @@
+#include "quasirandomnumbergenerator.hpp"
+
+#include <QDataStream>
+#include <QIODevice>
+#include <algorithm>
+#include <limits>
+
+#include "engines.hpp"
+
+
+namespace api
+{
+
+QuasiRandomNumberGenerator::QuasiRandomNumberGenerator(quint64 seed)
+    : m_seed{seed}
+    , m_index{0}
+    , m_dimension{0}
+{
+    // coordinates are assigned in the order of drawing, buffered numbers would shift them
+    setCounterBased(1);
+}
+
+int QuasiRandomNumberGenerator::operator()()
+{
+    return static_cast<int>(next() * 4294967296.0);
+}
+
+int QuasiRandomNumberGenerator::operator()(int to)
+{
+    return (*this)(0, to);
+}
+
+int QuasiRandomNumberGenerator::operator()(int from, int to)
+{
+    const auto range = static_cast<double>(static_cast<qint64>(to) - from + 1);
+    return static_cast<int>(std::min<qint64>(from + static_cast<qint64>(next() * range), to));
+}
+
+double QuasiRandomNumberGenerator::real(double from, double to)
+{
+    return from + (to - from) * next();
+}
+
+void QuasiRandomNumberGenerator::fill(std::span<double> values, double from, double to)
+{
+    for (auto& value : values)
+        value = real(from, to);
+}
+
+void QuasiRandomNumberGenerator::fill(std::span<int> values, int from, int to)
+{
+    for (auto& value : values)
+        value = (*this)(from, to);
+}
+
+std::uint64_t QuasiRandomNumberGenerator::hash(std::uint64_t first, std::uint64_t second) const
+{
+    auto mixer = tools::SplitMix64{m_seed ^ (first * 0xD1B54A32D192ED03) ^ (second * 0x8CB92BA72F3D8DD7)};
+    return mixer();
+}
+
+void QuasiRandomNumberGenerator::setIteration(qint64 iteration)
+{
+    m_index = static_cast<quint64>(iteration);
+    m_dimension = 0;
+}
+
+QByteArray QuasiRandomNumberGenerator::saveEngineState() const
+{
+    QByteArray state;
+    QDataStream stream(&state, QIODevice::WriteOnly);
+    stream << m_seed << m_index << static_cast<qint32>(m_dimension);
+    return state;
+}
+
+bool QuasiRandomNumberGenerator::restoreEngineState(const QByteArray& state)
+{
+    QDataStream stream(state);
+    quint64 seed = 0;
+    quint64 index = 0;
+    qint32 dimension = 0;
+    stream >> seed >> index >> dimension;
+    if (stream.status() != QDataStream::Ok || seed != m_seed || dimension < 0)
+        return false;
+    m_index = index;
+    m_dimension = dimension;
+    return true;
+}
+
+double QuasiRandomNumberGenerator::next()
+{
+    const auto dimension = m_dimension++;
+    if (dimension < dimensions())
+        return coordinate(m_index, dimension);
+    // padding of high dimensions, still a function of the seed and the iteration
+    return static_cast<double>(hash(m_index, static_cast<std::uint64_t>(dimension)) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+}  // namespace api
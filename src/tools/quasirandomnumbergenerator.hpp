@@ -0,0 +1,64 @@
+#pragma once
+
+#include "api/tools.hpp"
+#include <cstdint>
+
+
+namespace api
+{
+
+/**
+ * @brief The QuasiRandomNumberGenerator class
+ * Base of low-discrepancy sequences. Iteration i of the simulation gets the point i
+ * of the sequence, consecutive numbers drawn in the iteration are consecutive coordinates
+ * of the point (see NumberGenerator::point()). Coordinates beyond the supported dimension
+ * are pseudo-random. The sequence is randomized with the seed, independent seeds give
+ * independent estimates, their spread estimates the error of the result.
+ */
+class QuasiRandomNumberGenerator : public NumberGenerator
+{
+    Q_OBJECT
+
+public:
+    explicit QuasiRandomNumberGenerator(quint64 seed);
+
+    int operator()() override;
+    int operator()(int to) override;
+    int operator()(int from, int to) override;
+    double real(double from, double to) override;
+    void fill(std::span<double> values, double from, double to) override;
+    void fill(std::span<int> values, int from, int to) override;
+
+protected:
+    /**
+     * @brief dimensions
+     * @return number of coordinates computed from the sequence
+     */
+    virtual int dimensions() const = 0;
+
+    /**
+     * @brief coordinate
+     * @return randomized coordinate of the point in range <0, 1)
+     */
+    virtual double coordinate(quint64 index, int dimension) const = 0;
+
+    /**
+     * @brief hash
+     * @return well mixed 64 bits of the seed and values, used for randomization
+     */
+    std::uint64_t hash(std::uint64_t first, std::uint64_t second = 0) const;
+
+    void setIteration(qint64 iteration) override;
+    QByteArray saveEngineState() const override;
+    bool restoreEngineState(const QByteArray& state) override;
+
+private:
+    double next();
+
+private:
+    quint64 m_seed;
+    quint64 m_index;
+    int m_dimension;
+};
+
+}  // namespace api
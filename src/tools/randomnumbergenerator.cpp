@@ -1,29 +1,23 @@
-#pragma once
-
 #include "randomnumbergenerator.hpp"
 
+#include "numbergeneratorfactory.hpp"
+
 
 namespace api
 {
 
-int RandomNumberGenerator::operator()()
-{
-    return m_rd();
-}
+RandomNumberGenerator::RandomNumberGenerator(int stream)
+    : RandomNumberGenerator(tools::NumberGeneratorFactory::randomSeed(), stream)
+{}
 
-int RandomNumberGenerator::operator()(int to)
-{
-    return std::uniform_int_distribution(0, to)(m_rd);
-}
-
-int RandomNumberGenerator::operator()(int from, int to)
-{
-    return std::uniform_int_distribution(from, to)(m_rd);
-}
+RandomNumberGenerator::RandomNumberGenerator(int seed, int stream)
+    : EngineNumberGenerator<tools::Xoshiro256StarStar>(static_cast<quint32>(seed), stream)
+    , m_seed{seed}
+{}
 
-double RandomNumberGenerator::real(double from, double to)
+int RandomNumberGenerator::seed() const
 {
-    return std::uniform_real_distribution(from, to)(m_rd);
+    return m_seed;
 }
 
 }  // namespace api
@@ -1,24 +1,36 @@
 #pragma once
 
-#include "api/tools.hpp"
-#include <random>
+#include "enginenumbergenerator.hpp"
+#include "engines.hpp"
 
 
 namespace api
 {
 
-class RandomNumberGenerator : public NumberGenerator
+/**
+ * @brief The RandomNumberGenerator class
+ * Generator of unpredictable numbers. The seed is drawn from the entropy source once,
+ * numbers come from the fast xoshiro256** engine, so the run can be replayed with seed().
+ */
+class RandomNumberGenerator : public EngineNumberGenerator<tools::Xoshiro256StarStar>
 {
     Q_OBJECT
 
 public:
-    int operator()() override;
-    int operator()(int to) override;
-    int operator()(int from, int to) override;
-    double real(double from, double to) override;
+    explicit RandomNumberGenerator(int stream = 0);
+
+    /**
+     * @brief seed
+     * @return seed drawn from the entropy source, the same numbers are generated
+     * by xoshiro256** engine for this seed and stream
+     */
+    int seed() const;
+
+private:
+    RandomNumberGenerator(int seed, int stream);
 
 private:
-    std::random_device m_rd;
+    int m_seed;
 };
 
 }  // namespace api
@@ -0,0 +1,101 @@
+#include "sobolnumbergenerator.hpp"
+
+
+namespace api
+{
+
+namespace
+{
+struct Polynomial
+{
+    int degree;
+    quint32 coefficients;
+    std::array<quint32, 7> initial;
+};
+
+// dimensions 2-32 of new-joe-kuo-6.21201: degree s, coefficients a, initial direction numbers m
+constexpr std::array<Polynomial, SobolNumberGenerator::maxDimensions - 1> polynomials = {{
+    {1, 0, {1}},
+    {2, 1, {1, 3}},
+    {3, 1, {1, 3, 1}},
+    {3, 2, {1, 1, 1}},
+    {4, 1, {1, 1, 3, 3}},
+    {4, 4, {1, 3, 5, 13}},
+    {5, 2, {1, 1, 5, 5, 17}},
+    {5, 4, {1, 1, 5, 5, 5}},
+    {5, 7, {1, 1, 7, 11, 19}},
+    {5, 11, {1, 1, 5, 1, 1}},
+    {5, 13, {1, 1, 1, 3, 11}},
+    {5, 14, {1, 3, 5, 5, 31}},
+    {6, 1, {1, 3, 3, 9, 7, 49}},
+    {6, 13, {1, 1, 1, 15, 21, 21}},
+    {6, 16, {1, 3, 1, 13, 27, 49}},
+    {6, 19, {1, 1, 1, 15, 7, 5}},
+    {6, 22, {1, 3, 1, 15, 13, 25}},
+    {6, 25, {1, 1, 5, 5, 19, 61}},
+    {7, 1, {1, 3, 7, 11, 23, 15, 103}},
+    {7, 4, {1, 3, 7, 13, 13, 15, 69}},
+    {7, 7, {1, 1, 3, 13, 7, 35, 63}},
+    {7, 8, {1, 3, 5, 9, 1, 25, 53}},
+    {7, 14, {1, 3, 1, 13, 9, 35, 107}},
+    {7, 19, {1, 3, 1, 5, 27, 61, 31}},
+    {7, 21, {1, 1, 5, 11, 19, 41, 61}},
+    {7, 28, {1, 3, 5, 3, 3, 13, 69}},
+    {7, 31, {1, 1, 7, 13, 1, 19, 1}},
+    {7, 32, {1, 3, 7, 5, 13, 19, 59}},
+    {7, 37, {1, 1, 3, 9, 25, 29, 41}},
+    {7, 41, {1, 3, 5, 13, 23, 1, 55}},
+    {7, 42, {1, 3, 7, 3, 13, 59, 17}},
+}};
+}  // namespace
+
+SobolNumberGenerator::SobolNumberGenerator(quint64 seed)
+    : QuasiRandomNumberGenerator(seed)
+{
+    // the first dimension is the van der Corput sequence
+    for (int bit = 0; bit < 32; ++bit)
+        m_directions[0][bit] = quint32{1} << (31 - bit);
+
+    for (int dimension = 1; dimension < maxDimensions; ++dimension)
+    {
+        const auto& polynomial = polynomials[dimension - 1];
+        const auto s = polynomial.degree;
+        auto& directions = m_directions[dimension];
+        for (int bit = 0; bit < 32; ++bit)
+        {
+            if (bit < s)
+            {
+                directions[bit] = polynomial.initial[bit] << (31 - bit);
+                continue;
+            }
+            directions[bit] = directions[bit - s] ^ (directions[bit - s] >> s);
+            for (int k = 1; k < s; ++k)
+            {
+                if ((polynomial.coefficients >> (s - 1 - k)) & 1)
+                    directions[bit] ^= directions[bit - k];
+            }
+        }
+    }
+
+    for (int dimension = 0; dimension < maxDimensions; ++dimension)
+        m_shifts[dimension] = static_cast<quint32>(hash(~quint64{0}, dimension) >> 32);
+}
+
+int SobolNumberGenerator::dimensions() const
+{
+    return maxDimensions;
+}
+
+double SobolNumberGenerator::coordinate(quint64 index, int dimension) const
+{
+    const auto& directions = m_directions[dimension];
+    auto value = m_shifts[dimension];
+    for (int bit = 0; index != 0 && bit < 32; ++bit, index >>= 1)
+    {
+        if (index & 1)
+            value ^= directions[bit];
+    }
+    return value * (1.0 / 4294967296.0);
+}
+
+}  // namespace api
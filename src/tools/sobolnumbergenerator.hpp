@@ -0,0 +1,35 @@
+#pragma once
+
+#include "quasirandomnumbergenerator.hpp"
+#include <array>
+
+
+namespace api
+{
+
+/**
+ * @brief The SobolNumberGenerator class
+ * Sobol sequence in 32 dimensions (direction numbers of Joe, Kuo 2008) with 32-bit coordinates,
+ * randomized with a random digital shift, which keeps the net properties of the sequence.
+ * Points repeat after 2^32 iterations.
+ */
+class SobolNumberGenerator : public QuasiRandomNumberGenerator
+{
+    Q_OBJECT
+
+public:
+    static constexpr int maxDimensions = 32;
+
+public:
+    explicit SobolNumberGenerator(quint64 seed);
+
+protected:
+    int dimensions() const override;
+    double coordinate(quint64 index, int dimension) const override;
+
+private:
+    std::array<std::array<quint32, 32>, maxDimensions> m_directions;
+    std::array<quint32, maxDimensions> m_shifts;
+};
+
+}  // namespace api
@@ -0,0 +1,165 @@
+#include "variancereductionnumbergenerator.hpp"
+
+#include <QDataStream>
+#include <QIODevice>
+#include <algorithm>
+#include <numeric>
+
+#include "engines.hpp"
+
+
+namespace api
+{
+
+namespace
+{
+// separates the stream of permutations from streams seeded with the same seed
+constexpr std::uint64_t strataStream = 0x5354524154410000;
+}  // namespace
+
+VarianceReductionNumberGenerator::VarianceReductionNumberGenerator(std::unique_ptr<NumberGenerator> generator,
+                                                                   bool isAntithetic,
+                                                                   int stratifiedDimensions,
+                                                                   int seed)
+    : m_generator{std::move(generator)}
+    , m_isAntithetic{isAntithetic}
+    , m_stratifiedDimensions{std::clamp(stratifiedDimensions, 0, maxStratifiedDimensions)}
+    , m_recordedIteration{-1}
+    , m_isMirrored{false}
+    , m_position{0}
+    , m_strata(m_stratifiedDimensions)
+    , m_strataSeed{tools::SplitMix64{static_cast<std::uint64_t>(static_cast<quint32>(seed)) ^ strataStream}()}
+    , m_batchFirstIteration{0}
+    , m_batchIterations{0}
+    , m_iteration{0}
+{
+    // numbers depend on the position in the iteration, so only a few of them are prepared ahead
+    setCounterBased(4);
+}
+
+int VarianceReductionNumberGenerator::operator()()
+{
+    return static_cast<int>(static_cast<quint32>(next() * 4294967296.0));
+}
+
+int VarianceReductionNumberGenerator::operator()(int to)
+{
+    return (*this)(0, to);
+}
+
+int VarianceReductionNumberGenerator::operator()(int from, int to)
+{
+    const auto range = static_cast<double>(static_cast<qint64>(to) - from + 1);
+    return static_cast<int>(std::min<qint64>(from + static_cast<qint64>(next() * range), to));
+}
+
+double VarianceReductionNumberGenerator::real(double from, double to)
+{
+    return from + (to - from) * next();
+}
+
+void VarianceReductionNumberGenerator::fill(std::span<double> values, double from, double to)
+{
+    for (auto& value : values)
+        value = real(from, to);
+}
+
+void VarianceReductionNumberGenerator::fill(std::span<int> values, int from, int to)
+{
+    for (auto& value : values)
+        value = (*this)(from, to);
+}
+
+void VarianceReductionNumberGenerator::setIteration(qint64 iteration)
+{
+    m_iteration = iteration;
+    m_position = 0;
+    m_isMirrored = m_isAntithetic && iteration % 2 == 1 && m_recordedIteration == iteration - 1;
+    if (!m_isMirrored)
+    {
+        m_recorded.clear();
+        m_recordedIteration = iteration;
+        m_generator->beginIteration(iteration);
+    }
+}
+
+void VarianceReductionNumberGenerator::setBatch(qint64 firstIteration, qint64 iterations)
+{
+    m_generator->beginBatch(firstIteration, iterations);
+    m_batchFirstIteration = firstIteration;
+    m_batchIterations = iterations;
+    if (iterations < 2)
+        return;
+    // random permutation of strata for every dimension (Fisher-Yates),
+    // the batch is hashed into the state, so permutations of different batches do not overlap
+    auto engine = tools::SplitMix64{tools::SplitMix64{m_strataSeed ^ static_cast<std::uint64_t>(firstIteration)}()};
+    for (auto& strata : m_strata)
+    {
+        strata.resize(static_cast<std::size_t>(iterations));
+        std::iota(strata.begin(), strata.end(), std::uint32_t{0});
+        for (auto i = strata.size() - 1; i > 0; --i)
+        {
+            const auto j = static_cast<std::size_t>(static_cast<double>(engine() >> 11) * (1.0 / 9007199254740992.0) * static_cast<double>(i + 1));
+            std::swap(strata[i], strata[std::min(j, i)]);
+        }
+    }
+}
+
+QByteArray VarianceReductionNumberGenerator::saveEngineState() const
+{
+    // checkpoints are written between batches, strata of the next batch are drawn again
+    const auto generator = m_generator->saveState();
+    if (generator.isEmpty())
+        return {};
+    QByteArray state;
+    QDataStream stream(&state, QIODevice::WriteOnly);
+    stream << generator << m_recordedIteration << static_cast<quint32>(m_recorded.size());
+    for (auto value : m_recorded)
+        stream << value;
+    return state;
+}
+
+bool VarianceReductionNumberGenerator::restoreEngineState(const QByteArray& state)
+{
+    QDataStream stream(state);
+    QByteArray generator;
+    qint64 recordedIteration = -1;
+    quint32 recorded = 0;
+    stream >> generator >> recordedIteration >> recorded;
+    if (stream.status() != QDataStream::Ok || !m_generator->restoreState(generator))
+        return false;
+    m_recordedIteration = recordedIteration;
+    m_recorded.resize(recorded);
+    for (auto& value : m_recorded)
+        stream >> value;
+    return stream.status() == QDataStream::Ok;
+}
+
+double VarianceReductionNumberGenerator::next()
+{
+    const auto position = m_position++;
+    if (m_isMirrored)
+    {
+        // the partner may have drawn fewer numbers, the rest is independent
+        if (position < m_recorded.size())
+            return 1.0 - m_recorded[position];
+        return m_generator->uniform();
+    }
+
+    auto value = 0.0;
+    const auto indexInBatch = m_iteration - m_batchFirstIteration;
+    if (position < m_strata.size() && m_batchIterations > 1 && 0 <= indexInBatch && indexInBatch < m_batchIterations)
+    {
+        const auto stratum = m_strata[position][static_cast<std::size_t>(indexInBatch)];
+        value = (stratum + m_generator->uniform()) / static_cast<double>(m_batchIterations);
+    }
+    else
+    {
+        value = m_generator->uniform();
+    }
+    if (m_isAntithetic)
+        m_recorded.push_back(value);
+    return value;
+}
+
+}  // namespace api
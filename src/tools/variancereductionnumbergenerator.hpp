@@ -0,0 +1,74 @@
+#pragma once
+
+#include "api/tools.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+namespace api
+{
+
+/**
+ * @brief The VarianceReductionNumberGenerator class
+ * Decorator of a generator, which reduces the variance of simulation results.
+ * Antithetic: iteration 2k + 1 uses numbers 1 - u, where u are numbers of the iteration 2k,
+ * the negative correlation of the pair reduces the variance of monotone statistics.
+ * Stratified: the first numbers of iterations in a batch form a Latin hypercube,
+ * every number falls into a different stratum of the size 1 / (batch size).
+ * Strata are permuted with a stream of their own, derived from the seed and the first iteration
+ * of the batch, so the permutation never consumes the numbers of the source generator.
+ * The iteration without its partner (the partner ran in another batch of another replica)
+ * uses independent numbers, so the results stay unbiased.
+ */
+class VarianceReductionNumberGenerator : public NumberGenerator
+{
+    Q_OBJECT
+
+public:
+    static constexpr int maxStratifiedDimensions = 8;
+
+public:
+    /**
+     * @brief VarianceReductionNumberGenerator
+     * @param generator source of numbers
+     * @param isAntithetic pairs consecutive iterations
+     * @param stratifiedDimensions number of stratified numbers of every iteration <0, maxStratifiedDimensions>
+     * @param seed seed of the run, permutations of strata are derived from it
+     */
+    VarianceReductionNumberGenerator(std::unique_ptr<NumberGenerator> generator, bool isAntithetic, int stratifiedDimensions, int seed);
+
+    int operator()() override;
+    int operator()(int to) override;
+    int operator()(int from, int to) override;
+    double real(double from, double to) override;
+    void fill(std::span<double> values, double from, double to) override;
+    void fill(std::span<int> values, int from, int to) override;
+
+protected:
+    void setIteration(qint64 iteration) override;
+    void setBatch(qint64 firstIteration, qint64 iterations) override;
+    QByteArray saveEngineState() const override;
+    bool restoreEngineState(const QByteArray& state) override;
+
+private:
+    double next();
+
+private:
+    std::unique_ptr<NumberGenerator> m_generator;
+    bool m_isAntithetic;
+    int m_stratifiedDimensions;
+    // numbers of the last even iteration, mirrored by its odd partner
+    std::vector<double> m_recorded;
+    qint64 m_recordedIteration;
+    bool m_isMirrored;
+    std::size_t m_position;
+    // strata of every stratified dimension, permuted for the current batch
+    std::vector<std::vector<std::uint32_t>> m_strata;
+    std::uint64_t m_strataSeed;
+    qint64 m_batchFirstIteration;
+    qint64 m_batchIterations;
+    qint64 m_iteration;
+};
+
+}  // namespace api